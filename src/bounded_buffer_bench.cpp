@@ -0,0 +1,156 @@
+// bounded_buffer_bench.cpp
+/*
+ BoundedBuffer<T, Capacity> (include/bounded_buffer.h) vs the std::deque SharedBuffer of
+ producer_consumer_bounded_buffer.cpp, generalised to T, for move-only messages of 64B,
+ 1KB and 64KB.
+  One producer constructs messages (filling the payload) and one consumer moves them out
+  and reads them, through a 16-slot buffer. The deque version is SharedBuffer as written:
+  push_back(std::move(msg)) into the deque, then front() + pop_front(). BoundedBuffer
+  constructs each message directly in its slot and moves it out once. Reported per
+  size: messages/s, payload GB/s and heap allocations per message (global operator new).
+
+ Usage: ./bounded_buffer_bench [scale]   (message counts are multiplied by scale)
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include "./include/bounded_buffer.h"
+
+static std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+constexpr std::size_t CAPACITY = 16;
+
+// Move-only message with an N-byte inline payload.
+template <std::size_t N>
+struct Message {
+    uint64_t seq;
+    std::array<unsigned char, N - sizeof(uint64_t)> payload;
+
+    explicit Message(uint64_t s) : seq(s) { std::memset(payload.data(), static_cast<int>(s), payload.size()); }
+    Message(Message&&) noexcept = default;
+    Message& operator=(Message&&) noexcept = default;
+    Message(const Message&) = delete;
+    Message& operator=(const Message&) = delete;
+};
+
+// producer_consumer_bounded_buffer.cpp's SharedBuffer, for any T.
+template <typename T>
+class DequeBuffer {
+public:
+    bool push(T&& value) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [&]() { return buffer.size() < CAPACITY || closed; });
+        if (closed) return false;
+        buffer.push_back(std::move(value));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [&]() { return !buffer.empty() || closed; });
+        if (buffer.empty()) return std::nullopt;
+        std::optional<T> item(std::move(buffer.front()));
+        buffer.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        return item;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    std::mutex mtx;
+    std::deque<T> buffer;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    bool closed = false;
+};
+
+struct Result {
+    double msgs_per_s;
+    double gb_per_s;
+    double allocs_per_msg;
+    bool ok;
+};
+
+template <std::size_t N, typename Buffer, typename Produce>
+Result run(uint64_t messages, Buffer& buffer, Produce produce) {
+    long before = allocations.load();
+    uint64_t checksum = 0, expected = 0;
+    bool in_order = true;
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        uint64_t next = 0;
+        while (auto msg = buffer.pop()) {
+            in_order = in_order && msg->seq == next++;
+            checksum += msg->payload[0] + msg->payload[msg->payload.size() - 1];
+        }
+    });
+    for (uint64_t i = 0; i < messages; ++i) {
+        produce(buffer, i);
+        expected += 2 * static_cast<unsigned char>(i);
+    }
+    buffer.close();
+    consumer.join();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return {messages / s, messages * N / s / 1e9, static_cast<double>(allocations.load() - before) / messages,
+            in_order && checksum == expected};
+}
+
+template <std::size_t N>
+void compare(uint64_t messages) {
+    auto deque_result = [&]() {
+        DequeBuffer<Message<N>> buffer;
+        return run<N>(messages, buffer, [](auto& b, uint64_t i) { b.push(Message<N>(i)); });
+    }();
+    auto ring_result = [&]() {
+        sync_utils::BoundedBuffer<Message<N>, CAPACITY> buffer;
+        return run<N>(messages, buffer, [](auto& b, uint64_t i) { b.emplace(i); });
+    }();
+    auto row = [](const char* label, const Result& r) {
+        std::printf("  %-16s %12.0f %10.2f %12.3f %s\n", label, r.msgs_per_s, r.gb_per_s, r.allocs_per_msg,
+                    r.ok ? "" : "  ORDER/CHECKSUM MISMATCH");
+    };
+    std::printf("%zu-byte messages, %llu of them\n", N, static_cast<unsigned long long>(messages));
+    row("deque", deque_result);
+    row("BoundedBuffer", ring_result);
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread bounded_buffer_bench.cpp -o bounded_buffer_bench\n\n");
+    double scale = argc > 1 ? std::atof(argv[1]) : 1.0;
+    std::printf("1 producer, 1 consumer, capacity %zu\n", CAPACITY);
+    std::printf("  %-16s %12s %10s %12s\n", "buffer", "msgs/s", "GB/s", "allocs/msg");
+    compare<64>(static_cast<uint64_t>(2'000'000 * scale));
+    compare<1024>(static_cast<uint64_t>(1'000'000 * scale));
+    compare<65536>(static_cast<uint64_t>(50'000 * scale));
+    return 0;
+}
@@ -0,0 +1,173 @@
+// channel_bench.cpp
+/*
+ Channel<T>: MPMC blocking queue with close(), timeouts, move-only payloads and select().
+  The demo part shows close() waking every blocked receiver (the bounded buffer's
+  `running` flag + notify_one shutdown can leave a waiter stuck), recv_for timing out,
+  std::unique_ptr payloads, select() over two channels, and the CPU time select() burns
+  while blocked on one closed-and-drained channel and one open, empty channel (it must
+  park, not spin).
+
+  The benchmark pushes MESSAGES messages through one channel for several producer:consumer
+  ratios and reports msgs/sec for Channel<T> and for the textbook queue guarded by one
+  mutex and one condition_variable that wakes everyone with notify_all.
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <time.h>
+#include "./include/channel.h"
+
+using sync_utils::Channel;
+using namespace std::chrono_literals;
+
+// Baseline: one lock, one cv, notify_all on every push, poison-pill free shutdown via flag.
+template <typename T>
+class NaiveQueue {
+public:
+    void send(T value) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            q.push(std::move(value));
+        }
+        cv.notify_all();
+    }
+
+    std::optional<T> recv() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return !q.empty() || closed; });
+        if (q.empty()) return std::nullopt;
+        T value = std::move(q.front());
+        q.pop();
+        return value;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closed = true;
+        }
+        cv.notify_all();
+    }
+
+private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::queue<T> q;
+    bool closed = false;
+};
+
+template <typename Queue>
+double msgs_per_sec(int producers, int consumers, int messages) {
+    Queue queue;
+    std::atomic<long> received{0};
+    int per_producer = messages / producers;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> cons;
+    for (int c = 0; c < consumers; ++c) {
+        cons.emplace_back([&]() {
+            long local = 0;
+            while (auto v = queue.recv()) ++local;
+            received.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+    std::vector<std::thread> prods;
+    for (int p = 0; p < producers; ++p) {
+        prods.emplace_back([&]() {
+            for (int i = 0; i < per_producer; ++i) queue.send(i);
+        });
+    }
+    for (auto& t : prods) t.join();
+    queue.close();
+    for (auto& t : cons) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (received.load() != static_cast<long>(per_producer) * producers) {
+        std::printf("ERROR: received %ld of %ld\n", received.load(), static_cast<long>(per_producer) * producers);
+    }
+    return received.load() / secs;
+}
+
+// Bounded so that producers also exercise the not_full path.
+struct BoundedChannel : Channel<int> {
+    BoundedChannel() : Channel<int>(1024) {}
+};
+
+void demo() {
+    // close() wakes all blocked receivers.
+    Channel<int> ch;
+    std::vector<std::thread> receivers;
+    std::atomic<int> woke{0};
+    for (int i = 0; i < 4; ++i) {
+        receivers.emplace_back([&]() {
+            if (!ch.recv()) woke.fetch_add(1);
+        });
+    }
+    std::this_thread::sleep_for(20ms);
+    ch.close();
+    for (auto& t : receivers) t.join();
+    std::printf("close(): %d of 4 blocked receivers woke with nullopt\n", woke.load());
+
+    // recv_for times out on an empty channel.
+    Channel<int> idle;
+    auto t0 = std::chrono::steady_clock::now();
+    auto none = idle.recv_for(5ms);
+    std::printf("recv_for(5ms): %s after %.1f ms\n", none ? "value" : "timeout",
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+
+    // Move-only payloads and select().
+    Channel<std::unique_ptr<int>> fast, slow;
+    std::thread producer([&]() {
+        slow.send(std::make_unique<int>(1));
+        fast.emplace(new int(2));
+        fast.close();
+        slow.close();
+    });
+    std::vector<Channel<std::unique_ptr<int>>*> both{&fast, &slow};
+    while (auto got = sync_utils::select(both)) {
+        std::printf("select(): channel %zu delivered %d\n", got->first, *got->second);
+    }
+    producer.join();
+
+    // select() parks while a closed, drained channel sits next to an open, empty one.
+    Channel<int> done, pending;
+    done.close();
+    std::thread late([&]() {
+        std::this_thread::sleep_for(500ms);
+        pending.send(3);
+    });
+    std::vector<Channel<int>*> mixed{&done, &pending};
+    timespec cpu0{}, cpu1{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
+    auto w0 = std::chrono::steady_clock::now();
+    auto got = sync_utils::select(mixed);
+    auto wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0).count();
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
+    late.join();
+    double cpu = (cpu1.tv_sec - cpu0.tv_sec) * 1e3 + (cpu1.tv_nsec - cpu0.tv_nsec) / 1e6;
+    std::printf("select() over closed + empty: channel %zu delivered %d after %.1f ms, %.2f ms CPU%s\n",
+                got ? got->first : 0, got ? got->second : -1, wall, cpu, cpu > 0.1 * wall ? "  SPINNING" : "");
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread channel_bench.cpp -o channel_bench\n");
+    demo();
+
+    constexpr int MESSAGES = 1'000'000;
+    const int ratios[][2] = {{1, 1}, {1, 4}, {4, 1}, {4, 4}, {8, 8}, {1, 16}};
+    std::printf("\n%6s %6s %18s %18s %18s\n", "prod", "cons", "naive cv msgs/s", "Channel msgs/s", "Channel(1024) msgs/s");
+    for (auto& r : ratios) {
+        std::printf("%6d %6d %18.0f %18.0f %18.0f\n", r[0], r[1],
+                    msgs_per_sec<NaiveQueue<int>>(r[0], r[1], MESSAGES),
+                    msgs_per_sec<Channel<int>>(r[0], r[1], MESSAGES),
+                    msgs_per_sec<BoundedChannel>(r[0], r[1], MESSAGES));
+    }
+    return 0;
+}
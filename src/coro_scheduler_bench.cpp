@@ -0,0 +1,246 @@
+// coro_scheduler_bench.cpp
+/*
+ Periodic loops as C++20 coroutines vs one OS thread per loop.
+  scheduler.cpp runs each periodic job as a std::function that must run to completion,
+  and the PID/sensor programs hand-roll `while (running) { work(); sleep_for(...); }`
+  threads. With include/coro_scheduler.h the same loop is written as
+      for (;;) { work(); co_await coro::next_period(); }
+  and thousands of them share a few worker threads that resume released jobs in
+  earliest-deadline-first order.
+
+  The demo runs the sensor -> controller pair of pid_controller_1.cpp as two coroutines
+  on one worker thread. The benchmark runs N identical 10ms loops (a PID step each) for
+  a few seconds, once as coroutines on a small worker pool and once as N jthreads, and
+  reports jobs/s, release lateness, deadline misses, context switches and CPU time
+  (getrusage), and memory: coroutine frame bytes vs resident-set growth per thread.
+
+ Usage: ./coro_scheduler_bench [seconds_per_run] [max_thread_loops]
+  Thread-per-loop runs above max_thread_loops (default 1000) are skipped: thousands of
+  threads each waking every 10ms can take minutes just to start and stop on a small box.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "./include/coro_scheduler.h"
+#include "./include/latency_histogram.h"
+#include "./include/mailbox.h"
+
+using namespace std::chrono_literals;
+using coro::Clock;
+using perf_utils::LatencyHistogram;
+
+constexpr auto PERIOD = 10ms;
+
+struct Pid {
+    double kp = 1.0, ki = 0.1, kd = 0.01, dt = 0.01;
+    double integral = 0.0, prev = 0.0;
+    double compute(double error) {
+        integral += error * dt;
+        double d = (error - prev) / dt;
+        prev = error;
+        return kp * error + ki * integral + kd * d;
+    }
+};
+
+// State of one benchmark loop: a first-order plant under PID control.
+struct Loop {
+    Pid pid;
+    double plant = 1.0;
+    LatencyHistogram lateness; // Release -> start of the job
+
+    void step() {
+        double u = pid.compute(-plant);
+        plant += u * pid.dt;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Demo: pid_controller_1.cpp's sensor and controller loops as coroutines.
+
+coro::PeriodicTask sensor_task(const double& plant, sync_utils::Mailbox<double>& reading, int jobs) {
+    auto& self = co_await coro::current_promise{};
+    for (int i = 0; i < jobs; ++i) {
+        double sample = plant;
+        // Sensor processing delay, without holding a thread while waiting. It ends inside the
+        // 500ms period: the original thread's back-to-back 500ms sleep would leave no slack
+        // for wake-up latency and miss every deadline.
+        co_await coro::sleep_until{self.release + 450ms};
+        reading.write(sample);
+        co_await coro::next_period();
+    }
+}
+
+coro::PeriodicTask controller_task(double& plant, sync_utils::Mailbox<double>& reading, int jobs) {
+    Pid pid;
+    for (int i = 0; i < jobs; ++i) {
+        double u = pid.compute(0.0 - reading.read());
+        plant += u * pid.dt;
+        if (i % 50 == 0) std::printf("  controller job %3d: plant = %+.4f\n", i, plant);
+        co_await coro::next_period();
+    }
+}
+
+void demo() {
+    std::printf("pid_controller_1 loops as coroutines on one worker thread (2s):\n");
+    double plant = 1.0;
+    sync_utils::Mailbox<double> reading(1.0);
+    coro::CoroScheduler scheduler(1);
+    scheduler.spawn(sensor_task(plant, reading, 4), 500ms);
+    scheduler.spawn(controller_task(plant, reading, 200), 10ms);
+    scheduler.start();
+    std::this_thread::sleep_for(2s);
+    scheduler.stop();
+    auto st = scheduler.stats();
+    std::printf("  %llu jobs, %llu deadline misses\n\n", static_cast<unsigned long long>(st.jobs),
+                static_cast<unsigned long long>(st.misses));
+}
+
+// ---------------------------------------------------------------------------
+
+struct Usage {
+    double cpu_s;
+    long switches;
+    long rss_kb;
+};
+
+Usage usage_now() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    long rss = 0;
+    if (std::FILE* f = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        while (std::fgets(line, sizeof(line), f))
+            if (std::strncmp(line, "VmRSS:", 6) == 0) rss = std::atol(line + 6);
+        std::fclose(f);
+    }
+    double cpu = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e-6;
+    return {cpu, ru.ru_nvcsw + ru.ru_nivcsw, rss};
+}
+
+struct RunResult {
+    uint64_t jobs = 0;
+    uint64_t misses = 0;
+    LatencyHistogram lateness;
+    Usage before, after;
+    std::size_t frame_bytes = 0;
+    double seconds = 0.0; // First release -> stop
+    bool ok = true;
+};
+
+coro::PeriodicTask loop_task(Loop& loop) {
+    for (;;) {
+        auto& p = co_await coro::current_promise{};
+        loop.lateness.record(Clock::now() - p.release);
+        loop.step();
+        co_await coro::next_period();
+    }
+}
+
+RunResult run_coroutines(int n, unsigned threads, std::chrono::duration<double> duration) {
+    std::vector<Loop> loops(n);
+    RunResult r;
+    r.before = usage_now();
+    {
+        coro::CoroScheduler scheduler(threads);
+        auto start = Clock::now() + 20ms;
+        for (int i = 0; i < n; ++i) {
+            // Spread first releases over one period, like independently started loops.
+            scheduler.spawn(loop_task(loops[i]), PERIOD, start + PERIOD * i / n);
+        }
+        r.frame_bytes = coro::PeriodicTask::frame_bytes().load();
+        scheduler.start();
+        std::this_thread::sleep_for(duration);
+        r.after = usage_now();
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        scheduler.stop();
+        auto st = scheduler.stats();
+        r.jobs = st.jobs;
+        r.misses = st.misses;
+    }
+    for (auto& l : loops) r.lateness.merge(l.lateness);
+    return r;
+}
+
+RunResult run_threads(int n, std::chrono::duration<double> duration) {
+    std::vector<Loop> loops(n);
+    std::vector<uint64_t> jobs(n), misses(n);
+    RunResult r;
+    r.before = usage_now();
+    {
+        std::vector<std::jthread> pool;
+        auto start = Clock::now() + 20ms;
+        try {
+            for (int i = 0; i < n; ++i) {
+                pool.emplace_back([&, i](std::stop_token st) {
+                    auto release = start + PERIOD * i / n;
+                    while (!st.stop_requested()) {
+                        std::this_thread::sleep_until(release);
+                        loops[i].lateness.record(Clock::now() - release);
+                        loops[i].step();
+                        if (Clock::now() > release + PERIOD) ++misses[i];
+                        ++jobs[i];
+                        release += PERIOD;
+                    }
+                });
+            }
+        } catch (const std::system_error& e) {
+            std::printf("  thread creation failed after %zu threads: %s\n", pool.size(), e.what());
+            r.ok = false;
+        }
+        std::this_thread::sleep_for(duration);
+        r.after = usage_now();
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        // Stop all first: joining one by one would let the rest keep running meanwhile.
+        for (auto& t : pool) t.request_stop();
+    }
+    for (int i = 0; i < n; ++i) {
+        r.jobs += jobs[i];
+        r.misses += misses[i];
+        r.lateness.merge(loops[i].lateness);
+    }
+    return r;
+}
+
+void print_row(const char* label, int n, const RunResult& r) {
+    const double seconds = r.seconds;
+    double cpu = r.after.cpu_s - r.before.cpu_s;
+    long switches = r.after.switches - r.before.switches;
+    long rss = r.after.rss_kb - r.before.rss_kb;
+    std::printf("%-14s %6d %10.0f %10.1f %10.1f %8llu %12.0f %8.1f%% %12.0f %10.1f\n", label, n, r.jobs / seconds,
+                r.lateness.percentile(50) / 1e3, r.lateness.percentile(99) / 1e3,
+                static_cast<unsigned long long>(r.misses), switches / seconds, 100.0 * cpu / seconds,
+                r.frame_bytes ? static_cast<double>(r.frame_bytes) / n : 0.0, static_cast<double>(rss) / n);
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread coro_scheduler_bench.cpp -o coro_scheduler_bench\n\n");
+    double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    int max_thread_loops = argc > 2 ? std::atoi(argv[2]) : 1000;
+    unsigned workers = std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+    demo();
+
+    auto d = std::chrono::duration<double>(seconds);
+    std::printf("%d-ms loops, %.1fs per run, coroutines on %u worker thread(s)\n",
+                static_cast<int>(PERIOD.count()), seconds, workers);
+    std::printf("%-14s %6s %10s %10s %10s %8s %12s %9s %12s %10s\n", "model", "loops", "jobs/s", "late p50us",
+                "late p99us", "misses", "ctx-sw/s", "CPU", "frame B/loop", "RSS KB/loop");
+    for (int n : {100, 1000, 4000}) {
+        print_row("coroutines", n, run_coroutines(n, workers, d));
+        if (n > max_thread_loops) {
+            std::printf("%-14s %6d   (skipped, above max_thread_loops)\n", "thread/loop", n);
+            continue;
+        }
+        auto t = run_threads(n, d);
+        print_row(t.ok ? "thread/loop" : "thread/loop*", n, t);
+    }
+    return 0;
+}
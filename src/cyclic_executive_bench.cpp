@@ -0,0 +1,184 @@
+// cyclic_executive_bench.cpp
+/*
+ Static cyclic executive (include/cyclic_executive.h) vs the runtime EDF loop of scheduler.cpp.
+  scheduler.cpp decides every dispatch at run time: it locks a mutex, reads system_clock,
+  scans the task list and pushes/pops a priority_queue. Its task set never changes, so the
+  whole schedule can be computed by the compiler instead:
+
+      using Set = cyclic::TaskSet<cyclic::Task<1'000'000, 200'000>, // period, WCET in us
+                                  cyclic::Task<2'000'000, 300'000>, cyclic::Task<500'000, 100'000>>;
+      cyclic::CyclicExecutive<Set> exec(sensorReading, controlLoop, sensorReading);
+
+  and an unschedulable set is a compile error rather than deadline misses in the field.
+
+  The benchmark runs scheduler.cpp's task set 100x faster (periods 10/20/5ms, WCET
+  2/3/1ms, each job busy for half its WCET) under both dispatchers and reports,
+  per task, start time relative to release (p1/p50/p99/max, and the p99-p1 spread as
+  jitter), plus the dispatch gap: time from one job's end to the next job's start when
+  jobs run back to back. A job's start offset within its period is fixed by the static
+  table (T1 always runs in the second frame), so compare spreads, not medians.
+
+ Usage: ./cyclic_executive_bench [seconds_per_run]
+*/
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <stop_token>
+#include <vector>
+#include "./include/cyclic_executive.h"
+#include "./include/latency_histogram.h"
+#include "./include/rt_thread.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+using perf_utils::LatencyHistogram;
+
+// scheduler.cpp's set at 1/100 of its periods: sensor 1000/200ms, control 2000/300ms, fast sensor 500/100ms.
+using SchedulerSet = cyclic::TaskSet<cyclic::Task<10000, 2000>, cyclic::Task<20000, 3000>, cyclic::Task<5000, 1000>>;
+static_assert(SchedulerSet::schedulable);
+
+// U = 0.9, but job 1 of the 4us task is released at 4 and due at 8, and no frame size
+// that divides 20 and holds the 5us job fits inside [4, 8): needs preemption.
+static_assert(!cyclic::TaskSet<cyclic::Task<4, 1>, cyclic::Task<5, 2>, cyclic::Task<20, 5>>::schedulable);
+// U > 1.
+static_assert(!cyclic::TaskSet<cyclic::Task<500, 300>, cyclic::Task<1000, 450>>::schedulable);
+
+constexpr std::size_t TASKS = SchedulerSet::size;
+
+// Per-task job accounting shared by both dispatchers.
+struct Recorder {
+    Clock::time_point origin;
+    std::array<uint64_t, TASKS> job{};
+    std::array<LatencyHistogram, TASKS> start; // Job start - release
+    LatencyHistogram gap;                      // Previous job end -> this job start, back-to-back jobs only
+    Clock::time_point last_end{};
+    uint64_t misses = 0;
+
+    void run_job(int task) {
+        auto now = Clock::now();
+        auto period = std::chrono::microseconds(SchedulerSet::periods[task]);
+        auto release = origin + period * job[task];
+        start[task].record(now - release);
+        // Back to back: the previous job ended after this one was released.
+        if (last_end > release) gap.record(now - last_end);
+        rt_utils::spin_for(std::chrono::microseconds(SchedulerSet::wcets[task]) / 2);
+        last_end = Clock::now();
+        if (last_end > release + period) ++misses;
+        ++job[task];
+    }
+};
+
+// The dispatch logic of Scheduler::schedulerLoop (scheduler.cpp), minus the printf calls
+// and the simulated sleep: mutex + system_clock per iteration, scan, priority_queue.
+class RuntimeEdf {
+public:
+    struct Task {
+        int id;
+        int priority;
+        std::chrono::microseconds period;
+        std::chrono::system_clock::time_point next_deadline;
+    };
+
+    RuntimeEdf(Recorder& r, std::chrono::system_clock::time_point origin) : rec(r) {
+        const int priorities[TASKS] = {2, 1, 3};
+        for (std::size_t i = 0; i < TASKS; ++i)
+            tasks.push_back({static_cast<int>(i), priorities[i], std::chrono::microseconds(SchedulerSet::periods[i]),
+                             origin});
+    }
+
+    void run(std::stop_token st) {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (st.stop_requested()) break;
+            auto now = std::chrono::system_clock::now();
+            for (auto& task : tasks) {
+                if (task.next_deadline <= now) {
+                    ready_queue.push(&task);
+                    task.next_deadline += task.period;
+                }
+            }
+            if (!ready_queue.empty()) {
+                Task* task = ready_queue.top();
+                ready_queue.pop();
+                lock.unlock();
+                rec.run_job(task->id);
+            } else {
+                auto next_deadline = tasks[0].next_deadline;
+                for (const auto& task : tasks)
+                    if (task.next_deadline < next_deadline) next_deadline = task.next_deadline;
+                cv.wait_until(lock, next_deadline, [this]() { return !ready_queue.empty(); });
+            }
+        }
+    }
+
+private:
+    struct TaskComparator {
+        bool operator()(const Task* t1, const Task* t2) const {
+            if (t1->next_deadline == t2->next_deadline) return t1->priority < t2->priority;
+            return t1->next_deadline > t2->next_deadline;
+        }
+    };
+
+    Recorder& rec;
+    std::vector<Task> tasks;
+    std::priority_queue<Task*, std::vector<Task*>, TaskComparator> ready_queue;
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+void report(const char* model, const Recorder& r) {
+    std::printf("%s: %llu deadline misses\n", model, static_cast<unsigned long long>(r.misses));
+    std::printf("  %-6s %8s %10s %10s %10s %10s %12s\n", "task", "jobs", "start p1", "p50 us", "p99 us", "max us",
+                "jitter us");
+    for (std::size_t i = 0; i < TASKS; ++i) {
+        const auto& h = r.start[i];
+        std::printf("  T%-5zu %8llu %10.2f %10.2f %10.2f %10.2f %12.2f\n", i, static_cast<unsigned long long>(h.count()),
+                    h.percentile(1) / 1e3, h.percentile(50) / 1e3, h.percentile(99) / 1e3, h.max() / 1e3,
+                    (h.percentile(99) - h.percentile(1)) / 1e3);
+    }
+    r.gap.print("  dispatch gap");
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread cyclic_executive_bench.cpp -o cyclic_executive_bench\n\n");
+    double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+    std::printf("Static schedule (computed at compile time):\n");
+    SchedulerSet::print();
+    std::printf("\n");
+
+    {
+        Recorder rec;
+        cyclic::CyclicExecutive<SchedulerSet> exec([&rec](int t) { rec.run_job(t); }, [&rec](int t) { rec.run_job(t); },
+                                                   [&rec](int t) { rec.run_job(t); });
+        rec.origin = Clock::now() + 10ms;
+        uint64_t hyperperiods = static_cast<uint64_t>(seconds * 1e6 / SchedulerSet::hyperperiod);
+        exec.run({}, hyperperiods, rec.origin);
+        report("cyclic executive", rec);
+        const auto& st = exec.statistics();
+        std::printf("  %llu frames, %llu frame overruns\n", static_cast<unsigned long long>(st.frames),
+                    static_cast<unsigned long long>(st.overruns));
+        st.lateness.print("  frame wake lateness");
+    }
+    std::printf("\n");
+    {
+        Recorder rec;
+        rec.origin = Clock::now() + 10ms;
+        auto sys_origin = std::chrono::system_clock::now() + 10ms;
+        RuntimeEdf edf(rec, sys_origin);
+        std::stop_source stop;
+        std::jthread stopper([&]() {
+            std::this_thread::sleep_for(duration + 10ms);
+            stop.request_stop();
+        });
+        edf.run(stop.get_token());
+        report("runtime EDF (scheduler.cpp loop)", rec);
+    }
+    return 0;
+}
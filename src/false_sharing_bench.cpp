@@ -0,0 +1,185 @@
+// false_sharing_bench.cpp
+/*
+ Cost of false sharing in the repo's shared-state structs, packed vs CachePadded
+ (include/cache_padded.h).
+  1. Per-thread counters: T threads each increment their own atomic counter. Packed, all
+     counters share one line; padded, each owns a line.
+  2. pid_controller_grok_2.cpp's SharedData: a controller thread doing plant_state.add()
+     and a sensor thread doing sensor_value.store(), as fast as they can (the real program
+     sleeps between updates; a 10-100kHz loop on more sensors gets close to this).
+  3. SensorFusion's flags: sensor threads lock/unlock a mutex and append to a buffer while
+     the fusion thread polls `running` — packed next to the mutex, and on separate lines.
+  Threads are pinned to distinct CPUs when there are enough. With a single CPU the threads
+  never run at the same time, there is no coherence traffic, and both layouts measure the
+  same: run on a multi-core machine to see the difference.
+
+ Usage: ./false_sharing_bench [millions_of_ops_per_thread]
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "./include/atomic_plant.h"
+#include "./include/cache_padded.h"
+#include "./include/rt_thread.h"
+
+using sync_utils::CachePadded;
+
+constexpr int MAX_THREADS = 8;
+
+const std::vector<int> cpus = rt_utils::allowed_cpus();
+
+rt_utils::ThreadConfig pinned(int i) {
+    rt_utils::ThreadConfig cfg;
+    cfg.cpu = static_cast<int>(cpus.size()) > i ? cpus[i] : -1;
+    cfg.report = false;
+    return cfg;
+}
+
+// Run body(i) on `threads` pinned threads, started together; returns seconds.
+template <typename Body>
+double run_threads(int threads, Body body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::jthread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.push_back(rt_utils::make_jthread(pinned(i), [&, i]() {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(i);
+        }));
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    pool.clear(); // Joins
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// ---------------------------------------------------------------------------
+// 1. Per-thread counters
+
+struct PackedCounters {
+    std::atomic<uint64_t> c[MAX_THREADS];
+    std::atomic<uint64_t>& operator[](int i) { return c[i]; }
+};
+
+struct PaddedCounters {
+    CachePadded<std::atomic<uint64_t>> c[MAX_THREADS];
+    std::atomic<uint64_t>& operator[](int i) { return *c[i]; }
+};
+
+template <typename Counters>
+double counters_rate(int threads, uint64_t ops) {
+    Counters counters{};
+    double s = run_threads(threads, [&](int i) {
+        for (uint64_t n = 0; n < ops; ++n) counters[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    return threads * ops / s;
+}
+
+// ---------------------------------------------------------------------------
+// 2. grok_2 SharedData
+
+struct PackedShared {
+    control::AtomicPlant plant_state{1.0};
+    std::atomic<double> sensor_value{1.0};
+    control::AtomicPlant& plant() { return plant_state; }
+    std::atomic<double>& sensor() { return sensor_value; }
+};
+
+struct PaddedShared {
+    CachePadded<control::AtomicPlant> plant_state{1.0};
+    CachePadded<std::atomic<double>> sensor_value{1.0};
+    control::AtomicPlant& plant() { return *plant_state; }
+    std::atomic<double>& sensor() { return *sensor_value; }
+};
+
+template <typename Shared>
+double shared_rate(uint64_t ops) {
+    Shared shared;
+    double s = run_threads(2, [&](int i) {
+        if (i == 0) {
+            for (uint64_t n = 0; n < ops; ++n) shared.plant().add(1e-9); // Controller
+        } else {
+            for (uint64_t n = 0; n < ops; ++n) shared.sensor().store(static_cast<double>(n), std::memory_order_release);
+        }
+    });
+    return 2 * ops / s;
+}
+
+// ---------------------------------------------------------------------------
+// 3. SensorFusion readings mutex vs running flag
+
+struct PackedFusion {
+    std::mutex readings_mutex;
+    uint64_t readings = 0;
+    std::atomic<bool> running{true};
+};
+
+struct PaddedFusion {
+    alignas(sync_utils::CACHE_LINE) std::mutex readings_mutex;
+    uint64_t readings = 0;
+    CachePadded<std::atomic<bool>> running_flag{true};
+    std::atomic<bool>& running = *running_flag;
+};
+
+// Returns flag polls per second seen by the fusion thread while `sensors` threads ingest.
+template <typename Fusion>
+double fusion_poll_rate(int sensors, uint64_t ops) {
+    Fusion f;
+    std::atomic<int> done{0};
+    uint64_t polls = 0;
+    double s = run_threads(sensors + 1, [&](int i) {
+        if (i == 0) {
+            uint64_t n = 0;
+            while (done.load(std::memory_order_relaxed) < sensors) n += f.running.load(std::memory_order_relaxed);
+            polls = n;
+        } else {
+            for (uint64_t n = 0; n < ops; ++n) {
+                std::lock_guard<std::mutex> lock(f.readings_mutex);
+                ++f.readings;
+            }
+            done.fetch_add(1);
+        }
+    });
+    return polls / s;
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread false_sharing_bench.cpp -o false_sharing_bench\n\n");
+    uint64_t ops = static_cast<uint64_t>((argc > 1 ? std::atof(argv[1]) : 20.0) * 1e6);
+    std::printf("CACHE_LINE = %zu, sizeof(CachePadded<atomic<double>>) = %zu, %zu CPU(s) available\n", sync_utils::CACHE_LINE,
+                sizeof(CachePadded<std::atomic<double>>), cpus.size());
+    if (cpus.size() < 2) std::printf("(one CPU: threads never overlap, so expect no difference)\n");
+    std::printf("\n");
+
+    std::printf("1. Per-thread counters, %.0fM increments per thread (M ops/s)\n", ops / 1e6);
+    std::printf("%8s %12s %12s %8s\n", "threads", "packed", "padded", "speedup");
+    for (int t = 1; t <= MAX_THREADS; t *= 2) {
+        if (t > 1 && t > static_cast<int>(cpus.size()) * 2) break;
+        double packed = counters_rate<PackedCounters>(t, ops);
+        double padded = counters_rate<PaddedCounters>(t, ops);
+        std::printf("%8d %12.1f %12.1f %7.2fx\n", t, packed / 1e6, padded / 1e6, padded / packed);
+    }
+
+    std::printf("\n2. grok_2 SharedData: controller add() + sensor store(), %.0fM each (M ops/s)\n", ops / 1e6);
+    double packed = shared_rate<PackedShared>(ops);
+    double padded = shared_rate<PaddedShared>(ops);
+    std::printf("%8s %12.1f %12.1f %7.2fx\n", "", packed / 1e6, padded / 1e6, padded / packed);
+
+    std::printf("\n3. SensorFusion: fusion polls `running` while sensors ingest %.0fM readings each (M polls/s)\n",
+                ops / 1e6 / 4);
+    std::printf("%8s %12s %12s %8s\n", "sensors", "packed", "padded", "speedup");
+    for (int sensors : {1, 3}) {
+        double p = fusion_poll_rate<PackedFusion>(sensors, ops / 4);
+        double q = fusion_poll_rate<PaddedFusion>(sensors, ops / 4);
+        std::printf("%8d %12.1f %12.1f %7.2fx\n", sensors, p / 1e6, q / 1e6, q / p);
+    }
+    return 0;
+}
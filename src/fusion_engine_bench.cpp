@@ -0,0 +1,98 @@
+// fusion_engine_bench.cpp
+/*
+ EKF FusionEngine throughput with 3 to 100 sensors.
+  Readings are pre-generated (truth + per-sensor Gaussian noise, timestamps jittered so
+  every batch arrives out of order) and fed to FusionEngine::process() one round of
+  readings at a time, the way SensorFusion::fuse_data() hands over its buffer.
+  Reports updates/sec, ns/update, RMS position error against the truth, and the number
+  of heap allocations made inside the timed loop (expected: 0).
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <span>
+#include <vector>
+#include "./include/fusion_engine.h"
+
+using namespace fusion;
+
+static std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+double truth_at(double s) { return 50.0 + 20.0 * std::sin(0.5 * s); }
+
+void run(int sensors, int rounds) {
+    std::mt19937 rng(sensors);
+    std::vector<SensorModel> models;
+    for (int i = 0; i < sensors; ++i) {
+        switch (i % 3) {
+        case 0: models.push_back({"pos", MeasurementKind::Position, 1.0 + (i % 5)}); break;
+        case 1: models.push_back({"vel", MeasurementKind::Velocity, 0.5}); break;
+        default: models.push_back({"range", MeasurementKind::Range, 0.3, 5.0}); break;
+        }
+    }
+
+    // One round = every sensor reports once within a 1ms period, in random order.
+    const auto t0 = steady_clock::time_point{} + std::chrono::hours(1);
+    std::uniform_int_distribution<int> jitter_us(0, 999);
+    std::vector<SensorData> readings;
+    readings.reserve(static_cast<std::size_t>(sensors) * rounds);
+    for (int r = 0; r < rounds; ++r) {
+        for (int s = 0; s < sensors; ++s) {
+            auto ts = t0 + std::chrono::milliseconds(r) + std::chrono::microseconds(jitter_us(rng));
+            double sec = std::chrono::duration<double>(ts - t0).count();
+            double p = truth_at(sec);
+            double value = 0.0;
+            switch (models[s].kind) {
+            case MeasurementKind::Position: value = p; break;
+            case MeasurementKind::Velocity: value = 10.0 * std::cos(0.5 * sec); break;
+            case MeasurementKind::Range: value = std::sqrt(p * p + 25.0); break;
+            }
+            std::normal_distribution<double> noise(0.0, models[s].noise_stddev);
+            readings.push_back({value + noise(rng), ts, s});
+        }
+    }
+
+    FusionEngine<2> engine(models, 25.0);
+    double sq_err = 0.0;
+    long before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::span<SensorData> batch(readings.data() + static_cast<std::size_t>(r) * sensors, sensors);
+        engine.process(batch);
+        double err = engine.estimate_at(engine.time()).fused_value -
+                     truth_at(std::chrono::duration<double>(engine.time() - t0).count());
+        sq_err += err * err;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    long allocs = allocations.load() - before;
+
+    double secs = std::chrono::duration<double>(elapsed).count();
+    double updates = static_cast<double>(engine.update_count());
+    std::printf("%8d %14.0f %12.1f %12.3f %10llu %8ld\n", sensors, updates / secs,
+                secs * 1e9 / updates, std::sqrt(sq_err / rounds),
+                static_cast<unsigned long long>(engine.late_count()), allocs);
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread fusion_engine_bench.cpp -o fusion_engine_bench\n");
+    std::printf("%8s %14s %12s %12s %10s %8s\n", "sensors", "updates/s", "ns/update", "rms error", "late", "allocs");
+    const int total_readings = 2'000'000;
+    for (int sensors : {3, 10, 30, 100}) {
+        run(sensors, total_readings / sensors);
+    }
+    return 0;
+}
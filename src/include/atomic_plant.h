@@ -0,0 +1,63 @@
+#ifndef ATOMIC_PLANT_H
+#define ATOMIC_PLANT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+
+namespace control {
+
+// Plant state shared by several threads that all modify it (controller output,
+// disturbances, the plant's own dynamics) and readers (sensors).
+//
+// `x = load(); x' = f(x); store(x')` on a std::atomic<double> is race-free but not atomic
+// as a unit: two writers can load the same x and one of the updates is lost. Every
+// mutation here is a single read-modify-write:
+//   add(d)      - C++20 atomic<double>::fetch_add, for purely additive inputs (u * dt)
+//   update(f)   - compare_exchange loop for arbitrary transitions x' = f(x), e.g.
+//                 x' = x + (-a * x + b * u) * dt
+// f may run more than once under contention, so it must be a pure function of x.
+class AtomicPlant {
+public:
+    explicit AtomicPlant(double initial = 0.0) : state(initial) {}
+
+    double load() const { return state.load(std::memory_order_acquire); }
+
+    void store(double x) { state.store(x, std::memory_order_release); }
+
+    // Returns the new state.
+    double add(double delta) { return state.fetch_add(delta, std::memory_order_acq_rel) + delta; }
+
+    // Returns the new state.
+    template <typename F>
+    double update(F&& f) {
+        double x = state.load(std::memory_order_relaxed);
+        double next;
+        do {
+            next = f(x);
+        } while (!state.compare_exchange_weak(x, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return next;
+    }
+
+    bool is_lock_free() const { return state.is_lock_free(); }
+
+private:
+    std::atomic<double> state;
+};
+
+// sleep_for that returns early (false) once stop is requested on `st`, so a thread with
+// a long period does not hold up shutdown for a whole period.
+template <typename Rep, typename Period>
+bool sleep_for(std::stop_token st, std::chrono::duration<Rep, Period> d) {
+    std::mutex mtx;
+    std::condition_variable_any cv;
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait_for(lock, st, d, [] { return false; });
+    return !st.stop_requested();
+}
+
+} // namespace control
+
+#endif // ATOMIC_PLANT_H
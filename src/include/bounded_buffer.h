@@ -0,0 +1,248 @@
+#ifndef BOUNDED_BUFFER_H
+#define BOUNDED_BUFFER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace sync_utils {
+
+// What emplace() does when the buffer is full. Blocking back-pressures the producer,
+// which is right for work queues and wrong for a sensor that must keep its sampling
+// period; the other policies never make the producer wait for the consumer.
+struct OverflowPolicy {
+    enum class Mode {
+        Block,           // Wait for space (the original SharedBuffer behaviour)
+        BlockWithTimeout, // Wait up to `timeout`, then drop the new item
+        DropNewest,      // Drop the new item
+        DropOldest,      // Drop the oldest queued item to make room
+        OverwriteLatest, // Replace the most recently queued item with the new one
+    };
+
+    Mode mode = Mode::Block;
+    std::chrono::nanoseconds timeout{};
+
+    static OverflowPolicy block() { return {Mode::Block, {}}; }
+    static OverflowPolicy block_for(std::chrono::nanoseconds t) { return {Mode::BlockWithTimeout, t}; }
+    static OverflowPolicy drop_newest() { return {Mode::DropNewest, {}}; }
+    static OverflowPolicy drop_oldest() { return {Mode::DropOldest, {}}; }
+    static OverflowPolicy overwrite_latest() { return {Mode::OverwriteLatest, {}}; }
+};
+
+// Per-buffer counters. Every item passed to emplace() on an open buffer is counted in
+// exactly one of accepted, dropped_newest, timed_out or closed_waiting.
+struct OverflowStats {
+    uint64_t accepted = 0;       // Stored (including items that overwrote another)
+    uint64_t dropped_newest = 0; // Rejected because the buffer was full (DropNewest)
+    uint64_t timed_out = 0;      // Rejected after waiting `timeout` (BlockWithTimeout)
+    uint64_t closed_waiting = 0; // Rejected because close() ran while waiting for space (Block*)
+    uint64_t dropped_oldest = 0; // Queued items discarded to make room (DropOldest)
+    uint64_t overwritten = 0;    // Queued items replaced by a newer one (OverwriteLatest)
+};
+
+// Blocking multi-producer / multi-consumer queue of at most Capacity elements: the
+// SharedBuffer of producer_consumer_bounded_buffer.cpp for any T, including move-only
+// and large message types.
+//
+// Storage is one contiguous array of Capacity slots allocated at construction; elements
+// are constructed in place by emplace() and moved out by pop(), so steady-state traffic
+// allocates nothing (std::deque allocates and frees a chunk every few elements, and one
+// per element once T is larger than its 512-byte chunk).
+//
+// When full, emplace() follows the buffer's OverflowPolicy (blocking by default) and
+// counts what it dropped; see stats().
+//
+// close() ends the stream: blocked and later producers fail, consumers drain what is
+// left and then get std::nullopt.
+template <typename T, std::size_t Capacity>
+class BoundedBuffer {
+    static_assert(Capacity > 0, "Capacity must be positive");
+    static_assert(std::is_nothrow_move_constructible_v<T> || std::is_copy_constructible_v<T>,
+                  "pop() moves elements out");
+
+public:
+    explicit BoundedBuffer(OverflowPolicy policy = OverflowPolicy::block()) : overflow(policy), slots(new Slot[Capacity]) {}
+    BoundedBuffer(const BoundedBuffer&) = delete;
+    BoundedBuffer& operator=(const BoundedBuffer&) = delete;
+
+    ~BoundedBuffer() {
+        while (count > 0) destroy_head();
+    }
+
+    // Construct an element in place; when full, apply the overflow policy. false if the
+    // new item was not stored (dropped, timed out, or the buffer was closed).
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mtx);
+        auto has_space = [this]() { return count < Capacity || closed; };
+        if (!has_space()) {
+            switch (overflow.mode) {
+            case OverflowPolicy::Mode::Block:
+                not_full.wait(lock, has_space);
+                if (closed) {
+                    ++counters.closed_waiting;
+                    return false;
+                }
+                break;
+            case OverflowPolicy::Mode::BlockWithTimeout:
+                if (!not_full.wait_for(lock, overflow.timeout, has_space)) {
+                    ++counters.timed_out;
+                    return false;
+                }
+                if (closed) {
+                    ++counters.closed_waiting;
+                    return false;
+                }
+                break;
+            case OverflowPolicy::Mode::DropNewest:
+                ++counters.dropped_newest;
+                return false;
+            case OverflowPolicy::Mode::DropOldest:
+                destroy_head();
+                ++counters.dropped_oldest;
+                break;
+            case OverflowPolicy::Mode::OverwriteLatest:
+                overwrite_last(std::forward<Args>(args)...);
+                ++counters.overwritten;
+                ++counters.accepted;
+                return true; // Count unchanged: no consumer is waiting on a full buffer
+            }
+        }
+        if (closed) return false; // Closed before the call: not counted
+        construct(std::forward<Args>(args)...);
+        ++counters.accepted;
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    // Construct an element in place if there is space right now (ignores the policy and
+    // the counters).
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (closed || count == Capacity) return false;
+        construct(std::forward<Args>(args)...);
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    // Move the oldest element out, waiting for one. std::nullopt once closed and drained.
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [this]() { return count > 0 || closed; });
+        if (count == 0) return std::nullopt;
+        std::optional<T> out(std::in_place, std::move_if_noexcept(*element(head)));
+        destroy_head();
+        lock.unlock();
+        not_full.notify_one();
+        return out;
+    }
+
+    // Move the oldest element into `out` if there is one right now.
+    bool try_pop(T& out) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (count == 0) return false;
+        out = std::move_if_noexcept(*element(head));
+        destroy_head();
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return count;
+    }
+
+    OverflowStats stats() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return counters;
+    }
+
+    void set_overflow_policy(OverflowPolicy policy) {
+        std::lock_guard<std::mutex> lock(mtx);
+        overflow = policy;
+    }
+
+    bool is_closed() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return closed;
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    T* element(std::size_t i) { return std::launder(reinterpret_cast<T*>(slots[i].bytes)); }
+
+    static void advance(std::size_t& i) { i = i + 1 == Capacity ? 0 : i + 1; }
+
+    // Caller holds mtx.
+    template <typename... Args>
+    void construct(Args&&... args) {
+        ::new (static_cast<void*>(slots[tail].bytes)) T(std::forward<Args>(args)...);
+        advance(tail);
+        ++count;
+    }
+
+    // Caller holds mtx and count > 0. If T's constructor throws, the replaced element is
+    // lost (and not counted) and the exception propagates.
+    template <typename... Args>
+    void overwrite_last(Args&&... args) {
+        std::size_t last = tail == 0 ? Capacity - 1 : tail - 1;
+        element(last)->~T();
+        try {
+            ::new (static_cast<void*>(slots[last].bytes)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            tail = last;
+            --count;
+            throw;
+        }
+    }
+
+    // Caller holds mtx and count > 0.
+    void destroy_head() {
+        element(head)->~T();
+        advance(head);
+        --count;
+    }
+
+    mutable std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    OverflowPolicy overflow;
+    OverflowStats counters;
+    std::unique_ptr<Slot[]> slots;
+    std::size_t head = 0;  // Oldest element
+    std::size_t tail = 0;  // Next free slot
+    std::size_t count = 0;
+    bool closed = false;
+};
+
+} // namespace sync_utils
+
+#endif // BOUNDED_BUFFER_H
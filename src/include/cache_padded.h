@@ -0,0 +1,54 @@
+#ifndef CACHE_PADDED_H
+#define CACHE_PADDED_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sync_utils {
+
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns that the value depends on -mtune; it is only used for in-process layout here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+inline constexpr std::size_t CACHE_LINE = std::hardware_destructive_interference_size;
+#pragma GCC diagnostic pop
+#else
+inline constexpr std::size_t CACHE_LINE = 64;
+#endif
+
+// A T that owns whole cache lines: aligned to CACHE_LINE and, because sizeof is always a
+// multiple of alignof, padded up to the next line boundary. Two CachePadded members never
+// share a line, so a thread writing one does not invalidate the line another thread is
+// reading the other from (false sharing).
+//
+//   struct SharedData {
+//       sync_utils::CachePadded<std::atomic<double>> plant_state{1.0};  // Controller writes
+//       sync_utils::CachePadded<std::atomic<double>> sensor_value{1.0}; // Sensor writes
+//   };
+//   shared.plant_state->store(x);
+//
+// Pad data by who writes it, not field by field: members written by the same thread at
+// the same time belong on the same line.
+template <typename T>
+struct alignas(CACHE_LINE) CachePadded {
+    T value;
+
+    CachePadded() = default;
+
+    template <typename... Args>
+        requires(sizeof...(Args) > 0 && !(std::is_same_v<std::remove_cvref_t<Args>, CachePadded> || ...))
+    explicit CachePadded(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+    T& get() { return value; }
+    const T& get() const { return value; }
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+};
+
+} // namespace sync_utils
+
+#endif // CACHE_PADDED_H
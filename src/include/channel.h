@@ -0,0 +1,219 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sync_utils {
+
+namespace detail {
+
+// A thread blocked in select() over several channels. Channels signal it directly.
+struct SelectWaiter {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool signaled = false;
+
+    void signal() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            signaled = true;
+        }
+        cv.notify_one();
+    }
+};
+
+} // namespace detail
+
+// Multi-producer multi-consumer blocking queue with close semantics.
+//
+// Compared with the global queue + single cv in cond_var_example.cpp and the
+// `running` flag shutdown in producer_consumer_bounded_buffer.cpp:
+//   - close() is sticky and wakes every blocked sender, receiver and select(); receivers
+//     drain what is left and then get nullopt, so no waiter can be left stuck.
+//   - each send wakes at most one blocked receiver and one select() waiter, each recv at
+//     most one blocked sender, and only when someone is actually waiting (no herd, no
+//     futex syscall on the uncontended path). Notifications happen after unlocking.
+//   - elements are moved in and out, so move-only payloads work.
+// capacity == 0 means unbounded; otherwise send() blocks while the channel is full.
+template <typename T>
+class Channel {
+public:
+    explicit Channel(std::size_t capacity = 0) : capacity(capacity) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // Returns false if the channel is closed. `value` is consumed either way: a move-only
+    // value sent to a closed channel is destroyed, so keep it and use emplace() (whose
+    // arguments are untouched on failure) if it must survive a close.
+    bool send(T value) { return emplace(std::move(value)); }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (capacity != 0 && items.size() >= capacity && !closed) {
+            ++send_waiters;
+            not_full.wait(lock, [&]() { return items.size() < capacity || closed; });
+            --send_waiters;
+        }
+        if (closed) return false;
+        items.emplace_back(std::forward<Args>(args)...);
+        wake_receiver(lock);
+        return true;
+    }
+
+    // Non-blocking send; false if full or closed (`value` is consumed either way, as in send()).
+    bool try_send(T value) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (closed || (capacity != 0 && items.size() >= capacity)) return false;
+        items.push_back(std::move(value));
+        wake_receiver(lock);
+        return true;
+    }
+
+    // Blocks until an element is available; nullopt once closed and drained.
+    std::optional<T> recv() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (items.empty() && !closed) {
+            ++recv_waiters;
+            not_empty.wait(lock, [&]() { return !items.empty() || closed; });
+            --recv_waiters;
+        }
+        return take(lock);
+    }
+
+    std::optional<T> try_recv() {
+        std::unique_lock<std::mutex> lock(mtx);
+        return take(lock);
+    }
+
+    // nullopt on timeout or once closed and drained.
+    template <typename Rep, typename Period>
+    std::optional<T> recv_for(std::chrono::duration<Rep, Period> timeout) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (items.empty() && !closed) {
+            ++recv_waiters;
+            not_empty.wait_for(lock, timeout, [&]() { return !items.empty() || closed; });
+            --recv_waiters;
+        }
+        return take(lock);
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (closed) return;
+            closed = true;
+            for (auto* w : selectors) w->signal();
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    bool is_closed() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return closed;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return items.size();
+    }
+
+private:
+    template <typename U>
+    friend std::optional<std::pair<std::size_t, U>> select(const std::vector<Channel<U>*>& channels);
+
+    const std::size_t capacity;
+    mutable std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<T> items;
+    std::vector<detail::SelectWaiter*> selectors;
+    int recv_waiters = 0;
+    int send_waiters = 0;
+    bool closed = false;
+
+    // Caller holds `lock` and has just pushed one element.
+    void wake_receiver(std::unique_lock<std::mutex>& lock) {
+        // Hand the element to one select() waiter that has not been signalled yet;
+        // an already signalled one will re-scan every channel anyway.
+        for (auto* w : selectors) {
+            std::lock_guard<std::mutex> wl(w->mtx);
+            if (!w->signaled) {
+                w->signaled = true;
+                w->cv.notify_one();
+                break;
+            }
+        }
+        bool wake = recv_waiters > 0;
+        lock.unlock();
+        if (wake) not_empty.notify_one();
+    }
+
+    // Caller holds `lock`; pops the front element if any.
+    std::optional<T> take(std::unique_lock<std::mutex>& lock) {
+        if (items.empty()) return std::nullopt;
+        std::optional<T> value(std::move(items.front()));
+        items.pop_front();
+        bool wake = send_waiters > 0;
+        lock.unlock();
+        if (wake) not_full.notify_one();
+        return value;
+    }
+
+    // select() support: register, and report whether an element is already waiting.
+    // Clears `any_open` unless the channel is still open. A closed and drained channel is
+    // not ready: it can never deliver again, so it must not keep select() from parking.
+    bool add_selector(detail::SelectWaiter* w, bool& any_open) {
+        std::lock_guard<std::mutex> lock(mtx);
+        selectors.push_back(w);
+        if (!closed) any_open = true;
+        return !items.empty();
+    }
+
+    void remove_selector(detail::SelectWaiter* w) {
+        std::lock_guard<std::mutex> lock(mtx);
+        selectors.erase(std::find(selectors.begin(), selectors.end(), w));
+    }
+};
+
+// Receive from whichever channel has data first. Returns {index, value}, or nullopt once
+// every channel is closed and drained. Channels are scanned in order, so list the most
+// urgent one first. Blocks on a private waiter object that the channels signal, so a
+// select() over k channels costs k registrations, not k polling threads.
+template <typename T>
+std::optional<std::pair<std::size_t, T>> select(const std::vector<Channel<T>*>& channels) {
+    detail::SelectWaiter waiter;
+    for (;;) {
+        bool all_closed = true;
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            std::unique_lock<std::mutex> lock(channels[i]->mtx);
+            if (auto value = channels[i]->take(lock)) return std::make_pair(i, std::move(*value));
+            if (!channels[i]->closed) all_closed = false;
+        }
+        if (all_closed) return std::nullopt;
+
+        waiter.signaled = false;
+        bool ready = false;
+        bool any_open = false; // Re-checked under registration: the last open channel may have closed since the scan
+        for (auto* ch : channels) ready = ch->add_selector(&waiter, any_open) || ready;
+        if (!ready && any_open) {
+            std::unique_lock<std::mutex> lock(waiter.mtx);
+            waiter.cv.wait(lock, [&]() { return waiter.signaled; });
+        }
+        for (auto* ch : channels) ch->remove_selector(&waiter);
+    }
+}
+
+} // namespace sync_utils
+
+#endif // CHANNEL_H
@@ -0,0 +1,274 @@
+#ifndef CORO_SCHEDULER_H
+#define CORO_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace coro {
+
+using Clock = std::chrono::steady_clock;
+
+// Periodic work written as straight-line code:
+//
+//   coro::PeriodicTask control_loop(Plant& p) {
+//       for (;;) {
+//           p.step();
+//           co_await coro::next_period();
+//       }
+//   }
+//   scheduler.spawn(control_loop(plant), 10ms);
+//
+// A task is a job sequence: a job is released every period and must finish (reach its
+// next co_await next_period()) before its deadline, release + period. Between jobs the
+// coroutine frame sits in the scheduler's timer heap and holds no thread; released jobs
+// wait in a ready heap ordered by absolute deadline (EDF), and a small pool of worker
+// threads resumes them.
+class PeriodicTask {
+public:
+    struct promise_type {
+        Clock::time_point release{};  // Release time of the current job
+        Clock::time_point deadline{}; // Absolute deadline of the current job
+        Clock::time_point wake{};     // When the task is next runnable
+        Clock::duration period{};
+        uint64_t jobs = 0;
+        uint64_t misses = 0; // Jobs that reached next_period() after their deadline
+
+        PeriodicTask get_return_object() {
+            return PeriodicTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        // Like Scheduler's std::function work, a job has nowhere to report an error to.
+        void unhandled_exception() { std::terminate(); }
+
+        // Frame allocation is counted so the footprint of many tasks can be reported.
+        static void* operator new(std::size_t n) {
+            frame_bytes().fetch_add(n, std::memory_order_relaxed);
+            return ::operator new(n);
+        }
+        static void operator delete(void* p, std::size_t n) {
+            frame_bytes().fetch_sub(n, std::memory_order_relaxed);
+            ::operator delete(p);
+        }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    PeriodicTask(PeriodicTask&& o) noexcept : h(std::exchange(o.h, {})) {}
+    PeriodicTask& operator=(PeriodicTask&& o) noexcept {
+        std::swap(h, o.h);
+        return *this;
+    }
+    PeriodicTask(const PeriodicTask&) = delete;
+    PeriodicTask& operator=(const PeriodicTask&) = delete;
+    ~PeriodicTask() {
+        if (h) h.destroy();
+    }
+
+    // Hand the coroutine frame to a scheduler.
+    Handle release() { return std::exchange(h, {}); }
+
+    // Bytes currently held by live PeriodicTask frames, process-wide.
+    static std::atomic<std::size_t>& frame_bytes() {
+        static std::atomic<std::size_t> bytes{0};
+        return bytes;
+    }
+
+private:
+    explicit PeriodicTask(Handle handle) : h(handle) {}
+    Handle h;
+};
+
+// co_await next_period(): end the current job and sleep until the next release.
+struct next_period {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(PeriodicTask::Handle h) const noexcept {
+        auto& p = h.promise();
+        if (Clock::now() > p.release + p.period) ++p.misses; // Late against the job's own deadline
+        ++p.jobs;
+        p.release += p.period;
+        p.deadline = p.release + p.period;
+        p.wake = p.release;
+    }
+    void await_resume() const noexcept {}
+};
+
+// co_await sleep_until(t): suspend within the current job until t. The job keeps its
+// deadline, release + period, for EDF ordering and miss accounting; sleeping past it
+// makes the job late.
+struct sleep_until {
+    Clock::time_point t;
+
+    bool await_ready() const noexcept { return Clock::now() >= t; }
+    void await_suspend(PeriodicTask::Handle h) const noexcept {
+        auto& p = h.promise();
+        p.wake = t;
+    }
+    void await_resume() const noexcept {}
+};
+
+// co_await current_promise{}: the calling task's promise (release time, deadline, job
+// counts) without suspending.
+struct current_promise {
+    PeriodicTask::promise_type* p = nullptr;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(PeriodicTask::Handle h) noexcept {
+        p = &h.promise();
+        return false;
+    }
+    PeriodicTask::promise_type& await_resume() const noexcept { return *p; }
+};
+
+// Runs PeriodicTasks on `threads` worker threads with EDF ordering of resumptions.
+class CoroScheduler {
+public:
+    struct Stats {
+        uint64_t resumptions = 0;
+        uint64_t jobs = 0;
+        uint64_t misses = 0;
+        uint64_t late_resumptions = 0; // Resumed more than one period after becoming runnable
+    };
+
+    explicit CoroScheduler(unsigned threads = 1) : worker_count(std::max(1u, threads)) {}
+
+    CoroScheduler(const CoroScheduler&) = delete;
+    CoroScheduler& operator=(const CoroScheduler&) = delete;
+
+    ~CoroScheduler() {
+        stop();
+        while (!timers.empty()) {
+            timers.top().h.destroy();
+            timers.pop();
+        }
+        while (!ready.empty()) {
+            ready.top().h.destroy();
+            ready.pop();
+        }
+    }
+
+    // First release at `first_release` (default: now), then every `period`.
+    void spawn(PeriodicTask task, Clock::duration period, Clock::time_point first_release = Clock::now()) {
+        auto h = task.release();
+        auto& p = h.promise();
+        p.period = period;
+        p.release = p.wake = first_release;
+        p.deadline = first_release + period;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            timers.push({p.wake, h});
+            ++live;
+        }
+        cv.notify_one();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (running) return;
+        running = true;
+        for (unsigned i = 0; i < worker_count; ++i) workers.emplace_back([this]() { worker(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running = false;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        Stats s = totals;
+        auto add = [&s](const PeriodicTask::Handle& h) {
+            s.jobs += h.promise().jobs;
+            s.misses += h.promise().misses;
+        };
+        // Jobs/misses of tasks that are parked right now (finished tasks are in totals).
+        for (auto q = timers; !q.empty(); q.pop()) add(q.top().h);
+        for (auto q = ready; !q.empty(); q.pop()) add(q.top().h);
+        return s;
+    }
+
+    std::size_t task_count() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return live;
+    }
+
+private:
+    struct Entry {
+        Clock::time_point key; // Wake time in `timers`, absolute deadline in `ready`
+        PeriodicTask::Handle h;
+        bool operator>(const Entry& o) const { return key > o.key; }
+    };
+    using MinHeap = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+    const unsigned worker_count;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    MinHeap timers; // Suspended tasks by wake time
+    MinHeap ready;  // Runnable tasks by deadline (EDF)
+    std::vector<std::thread> workers;
+    std::size_t live = 0;
+    bool running = false;
+    Stats totals;
+
+    void worker() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (running) {
+            auto now = Clock::now();
+            while (!timers.empty() && timers.top().key <= now) {
+                auto h = timers.top().h;
+                timers.pop();
+                ready.push({h.promise().deadline, h});
+            }
+            if (ready.empty()) {
+                if (timers.empty()) cv.wait(lock);
+                else cv.wait_until(lock, timers.top().key);
+                continue;
+            }
+            auto h = ready.top().h;
+            ready.pop();
+            // Another worker may be able to take the next one.
+            if (!ready.empty()) cv.notify_one();
+            lock.unlock();
+
+            auto& p = h.promise();
+            bool late = Clock::now() - p.wake > p.period;
+            h.resume();
+
+            lock.lock();
+            ++totals.resumptions;
+            totals.late_resumptions += late;
+            if (h.done()) {
+                totals.jobs += p.jobs;
+                totals.misses += p.misses;
+                h.destroy();
+                --live;
+                continue;
+            }
+            bool earliest = timers.empty() || p.wake < timers.top().key;
+            timers.push({p.wake, h});
+            // A sleeping worker may be waiting for a later timer than this one.
+            if (earliest) cv.notify_one();
+        }
+    }
+};
+
+} // namespace coro
+
+#endif // CORO_SCHEDULER_H
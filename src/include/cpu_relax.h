@@ -0,0 +1,23 @@
+#ifndef CPU_RELAX_H
+#define CPU_RELAX_H
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sync_utils {
+
+// Spin-wait hint: tells the core we are in a busy-wait loop so it can yield pipeline
+// resources to a sibling hyperthread and avoid the memory-order mis-speculation flush
+// when the awaited cache line finally changes.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace sync_utils
+
+#endif // CPU_RELAX_H
@@ -0,0 +1,214 @@
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include "inplace_function.h"
+#include "latency_histogram.h"
+
+namespace cyclic {
+
+// A periodic task known at build time: released every PeriodUs microseconds, runs for at
+// most WcetUs, and must finish before its next release (deadline = period).
+template <uint64_t PeriodUs, uint64_t WcetUs>
+struct Task {
+    static_assert(PeriodUs > 0 && WcetUs > 0, "period and WCET must be positive");
+    static_assert(WcetUs <= PeriodUs, "WCET exceeds the task's period");
+    static constexpr uint64_t period = PeriodUs;
+    static constexpr uint64_t wcet = WcetUs;
+};
+
+// One job in the static schedule: job `job` of task `task` starts no later than `offset`
+// microseconds into the hyperperiod.
+struct Slot {
+    uint32_t task;
+    uint32_t job;
+    uint64_t offset;
+};
+
+// Compile-time frame schedule for a fixed task set:
+//
+//   using Set = cyclic::TaskSet<cyclic::Task<1000, 200>, cyclic::Task<500, 100>>;
+//   static_assert(Set::schedulable);
+//
+// The hyperperiod (lcm of the periods) is cut into equal frames. A frame size must divide
+// the hyperperiod and hold the largest WCET; jobs are then packed frame by frame in
+// deadline order, each into a frame that starts at or after its release and ends at or
+// before its deadline, so no job is ever split or preempted. The largest frame size that
+// packs every job wins (fewest timer wake-ups). Everything is evaluated by the compiler:
+// at run time the schedule is two constant arrays.
+template <typename... Tasks>
+class TaskSet {
+public:
+    static_assert(sizeof...(Tasks) > 0, "empty task set");
+
+    static constexpr std::size_t size = sizeof...(Tasks);
+    static constexpr std::array<uint64_t, size> periods{Tasks::period...};
+    static constexpr std::array<uint64_t, size> wcets{Tasks::wcet...};
+    static constexpr uint64_t hyperperiod = [] {
+        uint64_t h = 1;
+        for (uint64_t p : periods) h = std::lcm(h, p);
+        return h;
+    }();
+    static constexpr std::size_t jobs = ((hyperperiod / Tasks::period) + ...);
+    static constexpr double utilization = ((static_cast<double>(Tasks::wcet) / Tasks::period) + ...);
+
+private:
+    struct Packing {
+        bool ok = false;
+        std::array<Slot, jobs> slots{};
+        std::array<uint64_t, jobs> frame_of{};
+    };
+
+    static constexpr Packing pack(uint64_t f) {
+        Packing p;
+        std::array<uint64_t, size> next{}; // Next unplaced job of each task
+        std::size_t n = 0;
+        for (uint64_t k = 0; k < hyperperiod / f; ++k) {
+            const uint64_t start = k * f, end = start + f;
+            uint64_t used = 0;
+            for (;;) {
+                // Earliest-deadline job that is released, fits the rest of this frame and
+                // is still due at or after the frame's end.
+                std::size_t pick = size;
+                uint64_t pick_deadline = 0;
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (next[i] >= hyperperiod / periods[i]) continue;
+                    const uint64_t release = next[i] * periods[i], deadline = release + periods[i];
+                    if (release > start || deadline < end || wcets[i] > f - used) continue;
+                    if (pick == size || deadline < pick_deadline) {
+                        pick = i;
+                        pick_deadline = deadline;
+                    }
+                }
+                if (pick == size) break;
+                p.slots[n] = {static_cast<uint32_t>(pick), static_cast<uint32_t>(next[pick]), start + used};
+                p.frame_of[n] = k;
+                ++n;
+                used += wcets[pick];
+                ++next[pick];
+            }
+        }
+        p.ok = n == jobs;
+        return p;
+    }
+
+    static constexpr uint64_t max_wcet() {
+        uint64_t m = 0;
+        for (uint64_t w : wcets) m = w > m ? w : m;
+        return m;
+    }
+
+    static constexpr bool frame_fits(uint64_t f) { return f >= max_wcet() && pack(f).ok; }
+
+    // Divisors of the hyperperiod, largest first; 0 if none packs.
+    static constexpr uint64_t choose_frame() {
+        uint64_t r = 1;
+        while ((r + 1) * (r + 1) <= hyperperiod) ++r;
+        for (uint64_t i = 1; i <= r; ++i)
+            if (hyperperiod % i == 0 && frame_fits(hyperperiod / i)) return hyperperiod / i;
+        for (uint64_t i = r; i >= 1; --i)
+            if (hyperperiod % i == 0 && frame_fits(i)) return i;
+        return 0;
+    }
+
+public:
+    static constexpr uint64_t frame = utilization <= 1.0 ? choose_frame() : 0;
+    static constexpr bool schedulable = frame != 0;
+    static constexpr std::size_t frames = schedulable ? hyperperiod / frame : 1;
+
+    // Slots in execution order; frame k runs slots[frame_begin[k]] .. slots[frame_begin[k + 1] - 1].
+    static constexpr std::array<Slot, jobs> slots = pack(schedulable ? frame : hyperperiod).slots;
+    static constexpr std::array<uint32_t, frames + 1> frame_begin = [] {
+        std::array<uint32_t, frames + 1> begin{};
+        const auto frame_of = pack(schedulable ? frame : hyperperiod).frame_of;
+        for (std::size_t k = 0, s = 0; k <= frames; ++k) {
+            while (s < jobs && frame_of[s] < k) ++s;
+            begin[k] = static_cast<uint32_t>(s);
+        }
+        return begin;
+    }();
+
+    static void print(std::FILE* out = stdout) {
+        std::fprintf(out, "%zu tasks, U=%.3f, hyperperiod %lluus, ", size, utilization,
+                     static_cast<unsigned long long>(hyperperiod));
+        if (!schedulable) {
+            std::fprintf(out, "not schedulable\n");
+            return;
+        }
+        std::fprintf(out, "%zu frames of %lluus, %zu jobs\n", frames, static_cast<unsigned long long>(frame), jobs);
+        for (std::size_t k = 0; k < frames; ++k) {
+            std::fprintf(out, "  frame %3zu @%8lluus:", k, static_cast<unsigned long long>(k * frame));
+            for (uint32_t s = frame_begin[k]; s < frame_begin[k + 1]; ++s)
+                std::fprintf(out, " T%u.%u@+%llu", slots[s].task, slots[s].job,
+                             static_cast<unsigned long long>(slots[s].offset - k * frame));
+            std::fprintf(out, "\n");
+        }
+    }
+};
+
+// Runs a TaskSet's static schedule: sleep until the next frame boundary, call that frame's
+// jobs back to back, repeat. Dispatch is a walk over constant arrays and one indirect call
+// per job; there is no queue, lock or per-job clock read. work[i] is called with i.
+//
+//   cyclic::CyclicExecutive<Set> exec(sensorReading, controlLoop);
+//   std::jthread t([&](std::stop_token st) { exec.run(st); });
+template <typename Set>
+class CyclicExecutive {
+    static_assert(Set::utilization <= 1.0, "task set utilization exceeds 1");
+    static_assert(Set::schedulable, "no static frame schedule for this task set: no frame size that divides "
+                                    "the hyperperiod holds every job between its release and deadline");
+
+public:
+    using Clock = std::chrono::steady_clock;
+    using Work = func_utils::InplaceFunction<void(int)>;
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t jobs = 0;
+        uint64_t overruns = 0;                 // Frames whose jobs ran past the frame's end
+        perf_utils::LatencyHistogram lateness; // Frame boundary -> first job start
+    };
+
+    template <typename... F>
+    explicit CyclicExecutive(F&&... f) : work{Work(std::forward<F>(f))...} {
+        static_assert(sizeof...(F) == Set::size, "one work function per task");
+    }
+
+    // Run until stop is requested (checked at frame boundaries) or `hyperperiods` have
+    // elapsed. Frame 0 starts at `origin`: pass a shared epoch to align several executives.
+    void run(std::stop_token st = {}, uint64_t hyperperiods = UINT64_MAX, Clock::time_point origin = Clock::now()) {
+        const auto frame = std::chrono::microseconds(Set::frame);
+        auto boundary = origin;
+        for (uint64_t h = 0; h < hyperperiods; ++h) {
+            for (std::size_t k = 0; k < Set::frames; ++k) {
+                if (st.stop_requested()) return;
+                std::this_thread::sleep_until(boundary);
+                stats.lateness.record(Clock::now() - boundary);
+                for (uint32_t s = Set::frame_begin[k]; s < Set::frame_begin[k + 1]; ++s)
+                    work[Set::slots[s].task](static_cast<int>(Set::slots[s].task));
+                boundary += frame;
+                stats.overruns += Clock::now() > boundary;
+                stats.jobs += Set::frame_begin[k + 1] - Set::frame_begin[k];
+                ++stats.frames;
+            }
+        }
+    }
+
+    const Stats& statistics() const { return stats; }
+
+private:
+    std::array<Work, Set::size> work;
+    Stats stats;
+};
+
+} // namespace cyclic
+
+#endif // CYCLIC_EXECUTIVE_H
@@ -0,0 +1,87 @@
+#ifndef FOO_BAR_H
+#define FOO_BAR_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "cpu_relax.h"
+
+// How FooBar hands the turn between its two threads.
+enum class HandoffMode {
+    CondVar,      // Mutex + condition_variable: every alternation sleeps and is woken.
+    SpinThenPark, // Atomic turn flag: spin a bounded number of times, then atomic::wait.
+};
+
+// Print "foo" and "bar" alternately n times from two threads (foo_bar_print.cpp).
+class FooBar {
+private:
+    int n;
+    HandoffMode mode;
+    int spin_limit;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool foo_turn = true;
+    std::atomic<int> turn{0}; // 0: foo may run, 1: bar may run (SpinThenPark only).
+
+    void wait_turn(int want) {
+        for (int i = 0; i < spin_limit; ++i) {
+            if (turn.load(std::memory_order_acquire) == want) return;
+            sync_utils::cpu_relax();
+        }
+        int cur;
+        while ((cur = turn.load(std::memory_order_acquire)) != want) {
+            turn.wait(cur, std::memory_order_acquire);
+        }
+    }
+
+    void pass_turn(int next) {
+        turn.store(next, std::memory_order_release);
+        turn.notify_one(); // No syscall unless the peer actually parked.
+    }
+
+public:
+    // Spinning only pays off if the peer can run concurrently; on one CPU it just burns
+    // the peer's timeslice, so park immediately there.
+    static int default_spin_limit() { return std::thread::hardware_concurrency() > 1 ? 4000 : 0; }
+
+    // spin_limit is the number of pause-spins before parking; 0 parks immediately.
+    FooBar(int count, HandoffMode mode = HandoffMode::CondVar, int spin_limit = default_spin_limit())
+        : n(count), mode(mode), spin_limit(spin_limit) {}
+
+    template <typename PrintFoo>
+    void foo(PrintFoo printFoo) {
+        for (int i = 0; i < n; ++i) {
+            if (mode == HandoffMode::SpinThenPark) {
+                wait_turn(0);
+                printFoo();
+                pass_turn(1);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]() { return foo_turn; });
+            printFoo();
+            foo_turn = false;
+            cv.notify_all();
+        }
+    }
+
+    template <typename PrintBar>
+    void bar(PrintBar printBar) {
+        for (int i = 0; i < n; ++i) {
+            if (mode == HandoffMode::SpinThenPark) {
+                wait_turn(1);
+                printBar();
+                pass_turn(0);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]() { return !foo_turn; });
+            printBar();
+            foo_turn = true;
+            cv.notify_all();
+        }
+    }
+};
+
+#endif // FOO_BAR_H
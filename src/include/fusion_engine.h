@@ -0,0 +1,168 @@
+#ifndef FUSION_ENGINE_H
+#define FUSION_ENGINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kalman_filter.h"
+
+namespace fusion {
+
+using std::chrono::steady_clock;
+
+// A single sensor reading. sensor_id indexes the engine's SensorModel table.
+struct SensorData {
+    double value; // Sensor reading (e.g., position, velocity)
+    steady_clock::time_point timestamp;
+    int sensor_id = 0;
+};
+
+// Fused state estimate, valid at last_updated.
+struct StateEstimate {
+    double fused_value; // Estimated position
+    steady_clock::time_point last_updated;
+    double velocity = 0.0;
+    double variance = 0.0; // Position variance
+};
+
+enum class MeasurementKind {
+    Position, // z = p
+    Velocity, // z = v
+    Range,    // z = sqrt(p^2 + offset^2): a rangefinder mounted `offset` off the track
+};
+
+// Per-sensor noise and measurement model.
+struct SensorModel {
+    const char* name;
+    MeasurementKind kind;
+    double noise_stddev;
+    double range_offset = 0.0;
+};
+
+// Extended Kalman filter fusion over N-th order kinematics (N = 2: position + velocity).
+//
+// Readings are applied strictly in timestamp order: process() sorts its batch in place,
+// predicts the filter forward to each reading's timestamp and applies the sensor's
+// measurement model. Readings older than the filter's current time arrived too late to
+// be applied in order and are counted and skipped. estimate_at() predicts a copy of the
+// filter to the query time without disturbing it.
+//
+// The sensor table is allocated once at construction; updates do not allocate.
+template <std::size_t N = 2>
+class FusionEngine {
+    static_assert(N >= 2, "FusionEngine needs at least position and velocity");
+
+public:
+    FusionEngine(std::vector<SensorModel> models, double process_noise)
+        : models(std::move(models)), process_noise(process_noise) {}
+
+    // Apply a batch of readings in timestamp order. Returns the number applied.
+    std::size_t process(std::span<SensorData> batch) {
+        // Ties are broken on sensor_id, then value, so equal timestamps within a batch are
+        // applied in the same order whatever order they arrived in. Across batches the order is
+        // the order the batches were processed in.
+        std::sort(batch.begin(), batch.end(), [](const SensorData& a, const SensorData& b) {
+            if (a.timestamp != b.timestamp) return a.timestamp < b.timestamp;
+            if (a.sensor_id != b.sensor_id) return a.sensor_id < b.sensor_id;
+            return a.value < b.value;
+        });
+        std::size_t applied = 0;
+        for (const auto& reading : batch) applied += apply(reading) ? 1 : 0;
+        return applied;
+    }
+
+    // Apply one reading; the caller guarantees timestamp order across calls.
+    bool apply(const SensorData& reading) {
+        if (reading.sensor_id < 0 || static_cast<std::size_t>(reading.sensor_id) >= models.size()) {
+            ++unknown_sensor;
+            return false;
+        }
+        const SensorModel& model = models[reading.sensor_id];
+        if (!initialised) {
+            initialise(reading, model);
+            return true;
+        }
+        if (reading.timestamp < filter_time) {
+            ++late;
+            return false;
+        }
+        filter.predict(seconds(reading.timestamp - filter_time), process_noise);
+        filter_time = reading.timestamp;
+
+        double r = model.noise_stddev * model.noise_stddev;
+        switch (model.kind) {
+        case MeasurementKind::Position:
+            filter.update_component(0, reading.value, r);
+            break;
+        case MeasurementKind::Velocity:
+            filter.update_component(1, reading.value, r);
+            break;
+        case MeasurementKind::Range: {
+            double p = filter.state()(0, 0);
+            double range = std::sqrt(p * p + model.range_offset * model.range_offset);
+            Matrix<1, N> H;
+            H(0, 0) = range > 1e-9 ? p / range : 0.0; // d(range)/dp
+            filter.update(reading.value, range, H, r);
+            break;
+        }
+        }
+        ++updates;
+        return true;
+    }
+
+    // State predicted to time t (no prediction backwards past the last applied reading).
+    StateEstimate estimate_at(steady_clock::time_point t) const {
+        KalmanFilter<N> copy = filter;
+        if (initialised && t > filter_time) copy.predict(seconds(t - filter_time), process_noise);
+        const auto& x = copy.state();
+        return {x(0, 0), initialised ? std::max(t, filter_time) : t, x(1, 0), copy.covariance()(0, 0)};
+    }
+
+    steady_clock::time_point time() const { return filter_time; }
+    uint64_t update_count() const { return updates; }
+    uint64_t late_count() const { return late; }
+    uint64_t unknown_sensor_count() const { return unknown_sensor; }
+    std::size_t sensor_count() const { return models.size(); }
+    const SensorModel& model(int sensor_id) const { return models[sensor_id]; }
+
+private:
+    std::vector<SensorModel> models;
+    double process_noise;
+    KalmanFilter<N> filter;
+    steady_clock::time_point filter_time{};
+    bool initialised = false;
+    uint64_t updates = 0;
+    uint64_t late = 0;
+    uint64_t unknown_sensor = 0;
+
+    static double seconds(steady_clock::duration d) {
+        return std::chrono::duration<double>(d).count();
+    }
+
+    // Seed the state from the first reading: position from position/range sensors,
+    // everything else starts at zero with a wide prior.
+    void initialise(const SensorData& reading, const SensorModel& model) {
+        Vector<N> x0;
+        if (model.kind == MeasurementKind::Position) {
+            x0(0, 0) = reading.value;
+        } else if (model.kind == MeasurementKind::Range) {
+            double r2 = reading.value * reading.value - model.range_offset * model.range_offset;
+            x0(0, 0) = r2 > 0.0 ? std::sqrt(r2) : 0.0;
+        } else {
+            x0(1, 0) = reading.value;
+        }
+        filter.reset(x0, 1e4);
+        filter_time = reading.timestamp;
+        initialised = true;
+        ++updates;
+    }
+};
+
+} // namespace fusion
+
+#endif // FUSION_ENGINE_H
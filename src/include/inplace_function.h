@@ -0,0 +1,159 @@
+#ifndef INPLACE_FUNCTION_H
+#define INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace func_utils {
+
+template <typename Signature, std::size_t Capacity = 32, std::size_t Align = alignof(std::max_align_t)>
+class InplaceFunction;
+
+// Owning callable wrapper like std::function, but the callable always lives in a fixed
+// Capacity-byte buffer inside the object: constructing, copying or moving one never
+// allocates. A callable that does not fit is a compile error (raise Capacity or capture
+// less) instead of a silent heap fallback. Calls go through one function pointer in a
+// per-type table; calling an empty InplaceFunction throws std::bad_function_call.
+template <typename R, typename... Args, std::size_t Capacity, std::size_t Align>
+class InplaceFunction<R(Args...), Capacity, Align> {
+public:
+    InplaceFunction() noexcept : ops(&empty_ops) {}
+    InplaceFunction(std::nullptr_t) noexcept : ops(&empty_ops) {}
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<D, InplaceFunction> && std::is_invocable_r_v<R, D&, Args...>>>
+    InplaceFunction(F&& f) {
+        static_assert(sizeof(D) <= Capacity, "callable too large for this InplaceFunction's Capacity");
+        static_assert(Align % alignof(D) == 0, "callable alignment exceeds this InplaceFunction's Align");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "callable must be nothrow move constructible");
+        static_assert(std::is_copy_constructible_v<D>, "callable must be copy constructible");
+        if constexpr (std::is_pointer_v<std::remove_reference_t<F>> || std::is_member_pointer_v<D>) {
+            if (f == nullptr) {
+                ops = &empty_ops;
+                return;
+            }
+        }
+        ::new (static_cast<void*>(&storage)) D(std::forward<F>(f));
+        ops = &ops_for<D>;
+    }
+
+    InplaceFunction(const InplaceFunction& o) : ops(o.ops) { ops->copy(&storage, &o.storage); }
+
+    InplaceFunction(InplaceFunction&& o) noexcept : ops(o.ops) {
+        ops->move(&storage, &o.storage);
+        o.reset();
+    }
+
+    InplaceFunction& operator=(const InplaceFunction& o) {
+        if (this != &o) {
+            InplaceFunction tmp(o);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& o) noexcept {
+        if (this != &o) {
+            reset();
+            ops = o.ops;
+            ops->move(&storage, &o.storage);
+            o.reset();
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    ~InplaceFunction() { ops->destroy(&storage); }
+
+    R operator()(Args... args) const { return ops->invoke(&storage, std::forward<Args>(args)...); }
+
+    explicit operator bool() const noexcept { return ops != &empty_ops; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    struct alignas(Align) Storage {
+        unsigned char bytes[Capacity];
+    };
+
+    struct Ops {
+        R (*invoke)(const Storage*, Args&&...);
+        void (*copy)(Storage* dst, const Storage* src);
+        void (*move)(Storage* dst, Storage* src) noexcept;
+        void (*destroy)(Storage*) noexcept;
+    };
+
+    template <typename D>
+    static D* as(const Storage* s) {
+        return std::launder(reinterpret_cast<D*>(const_cast<Storage*>(s)));
+    }
+
+    template <typename D>
+    static constexpr Ops ops_for = {
+        [](const Storage* s, Args&&... args) -> R { return std::invoke(*as<D>(s), std::forward<Args>(args)...); },
+        [](Storage* dst, const Storage* src) { ::new (static_cast<void*>(dst)) D(*as<D>(src)); },
+        [](Storage* dst, Storage* src) noexcept { ::new (static_cast<void*>(dst)) D(std::move(*as<D>(src))); },
+        [](Storage* s) noexcept { as<D>(s)->~D(); },
+    };
+
+    static constexpr Ops empty_ops = {
+        [](const Storage*, Args&&...) -> R { throw std::bad_function_call(); },
+        [](Storage*, const Storage*) {},
+        [](Storage*, Storage*) noexcept {},
+        [](Storage*) noexcept {},
+    };
+
+    void reset() noexcept {
+        ops->destroy(&storage);
+        ops = &empty_ops;
+    }
+
+    mutable Storage storage;
+    const Ops* ops;
+};
+
+template <typename Signature>
+class function_ref;
+
+// Non-owning reference to a callable: one object pointer plus one function pointer,
+// trivially copyable, never allocates. For parameters that are only called during the
+// call (carArrived's turnGreen/goThrough): the referenced callable must outlive every
+// use, so never store a function_ref built from a temporary.
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+public:
+    template <typename F, typename D = std::remove_reference_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<std::remove_cv_t<D>, function_ref> &&
+                                          std::is_invocable_r_v<R, D&, Args...>>>
+    function_ref(F&& f) noexcept {
+        if constexpr (std::is_function_v<D>) {
+            obj = reinterpret_cast<void*>(&f);
+            thunk = [](void* o, Args&&... args) -> R {
+                return std::invoke(reinterpret_cast<D*>(o), std::forward<Args>(args)...);
+            };
+        } else {
+            obj = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            thunk = [](void* o, Args&&... args) -> R {
+                return std::invoke(*static_cast<D*>(o), std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const { return thunk(obj, std::forward<Args>(args)...); }
+
+private:
+    void* obj;
+    R (*thunk)(void*, Args&&...);
+};
+
+} // namespace func_utils
+
+#endif // INPLACE_FUNCTION_H
@@ -0,0 +1,148 @@
+#ifndef KALMAN_FILTER_H
+#define KALMAN_FILTER_H
+
+#include <array>
+#include <cstddef>
+
+namespace fusion {
+
+// Fixed-size row-major matrix. Dimensions are template parameters so every product below
+// is fully unrollable and nothing touches the heap.
+template <std::size_t R, std::size_t C>
+struct Matrix {
+    std::array<double, R * C> a{};
+
+    double& operator()(std::size_t r, std::size_t c) { return a[r * C + c]; }
+    double operator()(std::size_t r, std::size_t c) const { return a[r * C + c]; }
+
+    static Matrix identity() {
+        static_assert(R == C, "identity() needs a square matrix");
+        Matrix m;
+        for (std::size_t i = 0; i < R; ++i) m(i, i) = 1.0;
+        return m;
+    }
+
+    Matrix<C, R> transposed() const {
+        Matrix<C, R> t;
+        for (std::size_t r = 0; r < R; ++r)
+            for (std::size_t c = 0; c < C; ++c) t(c, r) = (*this)(r, c);
+        return t;
+    }
+
+    Matrix& operator+=(const Matrix& o) {
+        for (std::size_t i = 0; i < R * C; ++i) a[i] += o.a[i];
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix& o) {
+        for (std::size_t i = 0; i < R * C; ++i) a[i] -= o.a[i];
+        return *this;
+    }
+};
+
+template <std::size_t R, std::size_t K, std::size_t C>
+Matrix<R, C> operator*(const Matrix<R, K>& x, const Matrix<K, C>& y) {
+    Matrix<R, C> out;
+    for (std::size_t r = 0; r < R; ++r)
+        for (std::size_t k = 0; k < K; ++k) {
+            double v = x(r, k);
+            for (std::size_t c = 0; c < C; ++c) out(r, c) += v * y(k, c);
+        }
+    return out;
+}
+
+template <std::size_t R, std::size_t C>
+Matrix<R, C> operator+(Matrix<R, C> x, const Matrix<R, C>& y) { return x += y; }
+
+template <std::size_t R, std::size_t C>
+Matrix<R, C> operator-(Matrix<R, C> x, const Matrix<R, C>& y) { return x -= y; }
+
+template <std::size_t N>
+using Vector = Matrix<N, 1>;
+
+// Extended Kalman filter over an N-th order kinematic state
+// x = [position, velocity, acceleration, ...] (N entries).
+//
+// Measurements are scalar and applied one at a time (sequential update), so the
+// innovation covariance is a scalar and no matrix inverse is ever needed. Nonlinear
+// measurement models supply the predicted measurement h(x) and its Jacobian row H.
+template <std::size_t N>
+class KalmanFilter {
+public:
+    KalmanFilter() : P(Matrix<N, N>::identity()) {}
+
+    // Reset to a known state with isotropic uncertainty.
+    void reset(const Vector<N>& x0, double variance) {
+        x = x0;
+        P = Matrix<N, N>::identity();
+        for (auto& v : P.a) v *= variance;
+    }
+
+    // Propagate by dt seconds. q is the spectral density of the white noise driving the
+    // highest derivative (piecewise white noise model).
+    void predict(double dt, double q) {
+        if (dt <= 0.0) return;
+        Matrix<N, N> F = transition(dt);
+        Vector<N> G = noise_gain(dt);
+        Matrix<N, N> Q = G * G.transposed();
+        for (auto& v : Q.a) v *= q;
+        x = F * x;
+        P = F * P * F.transposed() + Q;
+    }
+
+    // Scalar measurement z with variance r; h_of_x = h(x), H = dh/dx at x.
+    // Returns the normalised innovation squared (useful for outlier gating).
+    double update(double z, double h_of_x, const Matrix<1, N>& H, double r) {
+        Vector<N> PHt = P * H.transposed();
+        double s = (H * PHt)(0, 0) + r;
+        double y = z - h_of_x;
+        Vector<N> K;
+        for (std::size_t i = 0; i < N; ++i) K(i, 0) = PHt(i, 0) / s;
+        for (std::size_t i = 0; i < N; ++i) x(i, 0) += K(i, 0) * y;
+        // Joseph-free form; P stays symmetric to rounding for these small dimensions.
+        P -= K * (H * P);
+        return y * y / s;
+    }
+
+    // Linear measurement of state component `index`.
+    double update_component(std::size_t index, double z, double r) {
+        Matrix<1, N> H;
+        H(0, index) = 1.0;
+        return update(z, x(index, 0), H, r);
+    }
+
+    const Vector<N>& state() const { return x; }
+    const Matrix<N, N>& covariance() const { return P; }
+
+private:
+    Vector<N> x;
+    Matrix<N, N> P;
+
+    // F(i, j) = dt^(j-i) / (j-i)! for j >= i.
+    static Matrix<N, N> transition(double dt) {
+        Matrix<N, N> F;
+        for (std::size_t i = 0; i < N; ++i) {
+            double term = 1.0;
+            for (std::size_t j = i; j < N; ++j) {
+                F(i, j) = term;
+                term *= dt / static_cast<double>(j - i + 1);
+            }
+        }
+        return F;
+    }
+
+    // G(i) = dt^(N-i) / (N-i)!: effect of a constant highest-derivative kick over dt.
+    static Vector<N> noise_gain(double dt) {
+        Vector<N> G;
+        for (std::size_t i = 0; i < N; ++i) {
+            double term = 1.0;
+            for (std::size_t k = 1; k <= N - i; ++k) term *= dt / static_cast<double>(k);
+            G(i, 0) = term;
+        }
+        return G;
+    }
+};
+
+} // namespace fusion
+
+#endif // KALMAN_FILTER_H
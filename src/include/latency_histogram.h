@@ -0,0 +1,98 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace perf_utils {
+
+// Log-linear latency histogram (HdrHistogram style): every power-of-two range is split
+// into SUB_BUCKETS linear buckets, so the relative error of any reported percentile is
+// bounded by 1/SUB_BUCKETS. Fixed storage, no allocation on record().
+// Not thread-safe: keep one per thread (or record under the owner's lock) and merge().
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value_ns) {
+        ++counts[index_of(value_ns)];
+        ++total;
+        sum += value_ns;
+        min_value = std::min(min_value, value_ns);
+        max_value = std::max(max_value, value_ns);
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> d) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(static_cast<uint64_t>(ns < 0 ? 0 : ns));
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    void reset() { *this = LatencyHistogram{}; }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // Upper bound of the bucket holding the p-th percentile (p in [0, 100]).
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        auto rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, total);
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(upper_bound_of(i), max_value);
+        }
+        return max_value;
+    }
+
+    // One-line summary in microseconds, e.g. for per-road or per-stage reports.
+    void print(const char* label) const {
+        std::printf("%-24s n=%-9llu mean=%9.2fus p50=%9.2fus p99=%9.2fus p99.9=%9.2fus max=%9.2fus\n",
+                    label, static_cast<unsigned long long>(total), mean() / 1e3,
+                    percentile(50) / 1e3, percentile(99) / 1e3, percentile(99.9) / 1e3,
+                    max() / 1e3);
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+
+    static int index_of(uint64_t v) {
+        if (v < SUB_BUCKETS) return static_cast<int>(v);
+        int msb = 63 - std::countl_zero(v);
+        int shift = msb - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((v >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t upper_bound_of(int index) {
+        if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS) | SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+};
+
+} // namespace perf_utils
+
+#endif // LATENCY_HISTOGRAM_H
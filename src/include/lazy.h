@@ -0,0 +1,133 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace sync_utils {
+
+// One-time initialised value with a single acquire load on the initialised path.
+//
+// std::call_once in libstdc++ goes through pthread_once (plus TLS bookkeeping for the
+// callable), which is more than hot readers of an already built lookup table need.
+// Lazy<T> keeps a three-state flag next to in-place storage for T:
+//   Empty -> Busy   one thread wins the CAS and runs the initialiser,
+//   Busy  -> Ready  on success (release store, waiters woken),
+//   Busy  -> Empty  if the initialiser throws or returns nullopt, so a later call retries.
+// Losers of the race park on the flag with atomic::wait rather than spinning.
+//
+// constexpr-constructible, so a namespace-scope Lazy is constant-initialised and immune
+// to static initialisation order problems.
+template <typename T>
+class Lazy {
+public:
+    constexpr Lazy() noexcept {}
+
+    Lazy(const Lazy&) = delete;
+    Lazy& operator=(const Lazy&) = delete;
+
+    ~Lazy() {
+        if (state.load(std::memory_order_acquire) == READY) {
+            std::destroy_at(ptr());
+        }
+    }
+
+    // Value if initialised, nullptr otherwise. Never blocks.
+    const T* get_if() const noexcept {
+        return state.load(std::memory_order_acquire) == READY ? ptr() : nullptr;
+    }
+
+    // init() -> T. Exceptions propagate to the caller that ran init and the value stays
+    // uninitialised, so the next caller retries.
+    template <typename F>
+    const T& get_or_init(F&& init) {
+        if (state.load(std::memory_order_acquire) == READY) [[likely]] return *ptr();
+        return *init_slow([&]() { return std::optional<T>(std::forward<F>(init)()); });
+    }
+
+    // init() -> std::optional<T>. Returns nullptr when init reports failure (nullopt);
+    // the value stays uninitialised and a later call retries.
+    template <typename F>
+    const T* try_get_or_init(F&& init) {
+        if (state.load(std::memory_order_acquire) == READY) [[likely]] return ptr();
+        return init_slow(std::forward<F>(init));
+    }
+
+private:
+    static constexpr uint32_t EMPTY = 0;
+    static constexpr uint32_t BUSY = 1;
+    static constexpr uint32_t READY = 2;
+
+    std::atomic<uint32_t> state{EMPTY};
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    // Marks the slot empty again if init leaves by exception.
+    struct ResetOnUnwind {
+        std::atomic<uint32_t>& state;
+        bool armed = true;
+        ~ResetOnUnwind() {
+            if (armed) {
+                state.store(EMPTY, std::memory_order_release);
+                state.notify_all();
+            }
+        }
+    };
+
+    template <typename F>
+    [[gnu::noinline]] const T* init_slow(F&& init) {
+        for (;;) {
+            uint32_t expected = EMPTY;
+            if (state.compare_exchange_strong(expected, BUSY, std::memory_order_acquire)) {
+                ResetOnUnwind guard{state};
+                std::optional<T> value = std::forward<F>(init)();
+                if (!value) return nullptr; // guard resets to EMPTY
+                ::new (static_cast<void*>(storage)) T(std::move(*value));
+                guard.armed = false;
+                state.store(READY, std::memory_order_release);
+                state.notify_all();
+                return ptr();
+            }
+            if (expected == READY) return ptr(); // failed CAS already loaded with acquire
+            state.wait(BUSY, std::memory_order_acquire);
+        }
+    }
+};
+
+// Lazy singleton whose readers cache the pointer in a thread_local after the first
+// successful read, so the steady-state read touches no shared cache line at all (and
+// needs no acquire barrier on weakly ordered CPUs). Tag distinguishes singletons of the
+// same type.
+template <typename T, typename Tag = T>
+class ThreadCachedLazy {
+public:
+    template <typename F>
+    static const T& get_or_init(F&& init) {
+        if (const T* p = cached) [[likely]] return *p;
+        const T& value = shared.get_or_init(std::forward<F>(init));
+        cached = &value;
+        return value;
+    }
+
+    template <typename F>
+    static const T* try_get_or_init(F&& init) {
+        if (const T* p = cached) [[likely]] return p;
+        const T* value = shared.try_get_or_init(std::forward<F>(init));
+        cached = value;
+        return value;
+    }
+
+private:
+    static inline Lazy<T> shared;
+    static inline thread_local const T* cached = nullptr;
+};
+
+} // namespace sync_utils
+
+#endif // LAZY_H
@@ -0,0 +1,86 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "cache_padded.h"
+
+namespace sync_utils {
+
+// Latest-value mailbox between one writer and one reader (triple buffer).
+//
+// For sensor -> controller hand-off the reader only ever wants the newest sample, and
+// the sample is more than one word (value + timestamp), so two separate atomics can be
+// observed torn and a mutex makes the writer wait for the reader. Here the writer fills
+// its private back slot and swaps it with the shared middle slot in one atomic exchange;
+// the reader swaps the middle slot with its private front slot when the "new" bit is set.
+// Neither side ever waits for the other (wait-free, one exchange per operation), a slot
+// is never read while being written, and an unread sample is simply replaced by a newer
+// one.
+//
+// Exactly one writer thread and one reader thread at a time.
+template <typename T>
+class Mailbox {
+    static_assert(std::is_trivially_copyable_v<T>, "Mailbox payloads are copied as plain bytes");
+
+public:
+    explicit Mailbox(const T& initial = T{}) {
+        for (auto& s : slots) s.value = initial;
+    }
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    // Writer side.
+    void write(const T& value) {
+        slots[back].value = value;
+        publish();
+    }
+
+    // Zero-copy writer side: fill back_buffer() in place, then publish().
+    T& back_buffer() { return slots[back].value; }
+
+    void publish() {
+        uint8_t prev = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = prev & INDEX;
+    }
+
+    // Reader side. Moves the newest published value into the front slot; returns false if
+    // nothing was published since the last call (the front slot is left unchanged).
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX;
+        return true;
+    }
+
+    // Newest value seen by update(); stable until the next update().
+    const T& front_buffer() const { return slots[front].value; }
+
+    // update() + front_buffer().
+    const T& read() {
+        update();
+        return slots[front].value;
+    }
+
+    // True if a value was published that the reader has not picked up yet.
+    bool has_new() const { return middle.load(std::memory_order_acquire) & FRESH; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    struct alignas(CACHE_LINE) Slot {
+        T value;
+    };
+
+    Slot slots[3];
+    alignas(CACHE_LINE) std::atomic<uint8_t> middle{1}; // Shared slot index | FRESH
+    alignas(CACHE_LINE) uint8_t back = 0;               // Writer-owned
+    alignas(CACHE_LINE) uint8_t front = 2;              // Reader-owned
+};
+
+} // namespace sync_utils
+
+#endif // MAILBOX_H
@@ -0,0 +1,75 @@
+#ifndef ORDERED_SEQUENCER_H
+#define ORDERED_SEQUENCER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "cache_padded.h"
+
+namespace sync_utils {
+
+// Turn-based barrier for N stages that must run in order 0, 1, ..., N-1, 0, 1, ...
+// (the generalisation of Foo in print_first.cpp and FooBar in foo_bar_print.cpp).
+//
+// Each stage owns a turn slot on its own cache line and parks on it with
+// std::atomic::wait, so a hand-off wakes only the next stage instead of every waiter
+// like cv.notify_all() does. The slot is a 32-bit counter because that is what the
+// Linux futex operates on directly; libstdc++ routes other widths through a proxy table.
+//
+// A stage is driven by one thread at a time (or by threads that hand it over with their
+// own synchronisation); different stages may run on different threads.
+template <std::size_t N>
+class OrderedSequencer {
+    static_assert(N >= 1, "OrderedSequencer needs at least one stage");
+
+public:
+    OrderedSequencer() { slots[0].turn.store(1, std::memory_order_relaxed); }
+
+    OrderedSequencer(const OrderedSequencer&) = delete;
+    OrderedSequencer& operator=(const OrderedSequencer&) = delete;
+
+    // Block until it is `stage`'s turn in its current round.
+    void wait_turn(std::size_t stage) {
+        Slot& s = slots[stage];
+        // turn == round means "not yet"; only our predecessor can move it to round + 1.
+        s.turn.wait(s.round, std::memory_order_acquire);
+    }
+
+    // Finish `stage`'s current round and pass the turn to the next stage.
+    void advance(std::size_t stage) {
+        ++slots[stage].round;
+        Slot& next = slots[(stage + 1) % N];
+        next.turn.fetch_add(1, std::memory_order_release);
+        next.turn.notify_one();
+    }
+
+    // Run `f` as `stage`'s step of the current round.
+    template <typename F>
+    void run(std::size_t stage, F&& f) {
+        wait_turn(stage);
+        std::forward<F>(f)();
+        advance(stage);
+    }
+
+    // Run `f` for `rounds` consecutive rounds of `stage` (round-robin repetition).
+    template <typename F>
+    void run_rounds(std::size_t stage, std::size_t rounds, F&& f) {
+        for (std::size_t i = 0; i < rounds; ++i) {
+            run(stage, f);
+        }
+    }
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<uint32_t> turn{0}; // Number of rounds this stage has been released for.
+        uint32_t round = 0;            // Rounds this stage has completed (owner-only).
+    };
+
+    std::array<Slot, N> slots;
+};
+
+} // namespace sync_utils
+
+#endif // ORDERED_SEQUENCER_H
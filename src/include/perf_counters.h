@@ -0,0 +1,371 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf_utils {
+
+// One hardware or software event counted for the calling thread (user space only), via
+// perf_event_open(2). Opening fails without PMU access (containers, VMs,
+// perf_event_paranoid > 2); valid() is then false and read() returns 0, so callers can
+// report the counter only when it exists.
+//
+// Passing a group leader's descriptor() as `group_fd` adds the event to that leader's
+// group: the group starts and stops together, and a leader opened with
+// PERF_FORMAT_GROUP returns every member's count in one read_group() call.
+class PerfCounter {
+public:
+    PerfCounter() = default; // Not counting: valid() is false
+
+    PerfCounter(uint32_t type, uint64_t config, int group_fd = -1, uint64_t read_format = 0, bool user_only = true) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.read_format = read_format;
+        attr.disabled = group_fd < 0 ? 1 : 0; // Members follow their leader
+        attr.exclude_kernel = user_only ? 1 : 0;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+#else
+        (void)type;
+        (void)config;
+        (void)group_fd;
+        (void)read_format;
+        (void)user_only;
+#endif
+    }
+
+    static PerfCounter hardware(uint64_t config) {
+#ifdef __linux__
+        return PerfCounter(PERF_TYPE_HARDWARE, config);
+#else
+        return PerfCounter(0, config);
+#endif
+    }
+
+    static PerfCounter cache_misses() {
+#ifdef __linux__
+        return hardware(PERF_COUNT_HW_CACHE_MISSES);
+#else
+        return hardware(0);
+#endif
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+    PerfCounter(PerfCounter&& o) noexcept : fd(std::exchange(o.fd, -1)) {}
+    PerfCounter& operator=(PerfCounter&& o) noexcept {
+        std::swap(fd, o.fd);
+        return *this;
+    }
+
+    ~PerfCounter() {
+#ifdef __linux__
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    bool valid() const { return fd >= 0; }
+    int descriptor() const { return fd; }
+
+    // Reset to zero and start counting (the whole group, on a leader).
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    uint64_t read() const {
+        uint64_t value = 0;
+#ifdef __linux__
+        if (fd >= 0 && ::read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) value = 0;
+#endif
+        return value;
+    }
+
+    // Leader opened with PERF_FORMAT_GROUP: counts of the leader and its members, in the
+    // order they were opened. Returns how many were stored in `values` (0 on failure).
+    std::size_t read_group(uint64_t* values, std::size_t max) const {
+#ifdef __linux__
+        uint64_t buf[1 + MAX_GROUP] = {};
+        ssize_t n = fd >= 0 ? ::read(fd, buf, sizeof(buf)) : -1;
+        if (n < static_cast<ssize_t>(sizeof(uint64_t))) return 0;
+        std::size_t count = std::min<std::size_t>({static_cast<std::size_t>(buf[0]), max, MAX_GROUP});
+        for (std::size_t i = 0; i < count; ++i) values[i] = buf[1 + i];
+        return count;
+#else
+        (void)values;
+        (void)max;
+        return 0;
+#endif
+    }
+
+    static constexpr std::size_t MAX_GROUP = 8;
+
+private:
+    int fd = -1;
+};
+
+// ---------------------------------------------------------------------------
+// PerfScope: RAII section counters aggregated per thread.
+//
+//   { perf_utils::PerfScope scope("PID::compute"); output = pid.compute(error); }
+//   ...join workers...
+//   perf_utils::perf_report();
+//
+// Each thread opens its counters once, on its first PerfScope, as one perf event group
+// and leaves them running; a scope reads the whole group on entry and exit (one read()
+// each) and adds the difference to the thread's totals for that section. Sections are
+// keyed by the address of the name literal, so a scope exit is a short pointer search
+// with no string built; totals are merged by name when the thread exits (or calls
+// perf_flush_thread()), so report after joining the threads of interest.
+//
+// Without PMU access the hardware columns print as n/a; wall time and context switches
+// (a software event in the group, or getrusage(RUSAGE_THREAD) when no hardware counter
+// opens) are always reported. A scope still costs two syscalls, a few hundred
+// nanoseconds, so wrapping a 50ns function measures mostly the scope: prefer wrapping a
+// loop or a batch.
+
+enum PerfEvent : int {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_CONTEXT_SWITCHES,
+    PERF_EVENT_COUNT
+};
+
+inline constexpr int PERF_HW_EVENTS = PERF_CONTEXT_SWITCHES; // Events that come from perf_event_open
+
+struct PerfTotals {
+    uint64_t calls = 0;
+    uint64_t wall_ns = 0;
+    std::array<uint64_t, PERF_EVENT_COUNT> events{};
+
+    void add(const PerfTotals& o) {
+        calls += o.calls;
+        wall_ns += o.wall_ns;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) events[e] += o.events[e];
+    }
+};
+
+using PerfSections = std::map<std::string, PerfTotals>;
+
+// Process-wide collection of per-thread totals.
+class PerfRegistry {
+public:
+    static PerfRegistry& instance() {
+        static PerfRegistry registry;
+        return registry;
+    }
+
+    void merge(long tid, const std::array<bool, PERF_HW_EVENTS>& valid, const PerfSections& sections) {
+        if (sections.empty()) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        for (int e = 0; e < PERF_HW_EVENTS; ++e) available[e] = available[e] || valid[e];
+        ThreadEntry* entry = nullptr;
+        for (auto& t : threads)
+            if (t.tid == tid) entry = &t;
+        if (!entry) entry = &threads.emplace_back(ThreadEntry{tid, {}});
+        for (const auto& [name, totals] : sections) entry->sections[name].add(totals);
+    }
+
+    void print(std::FILE* out) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        bool any_hw = false;
+        for (bool a : available) any_hw = any_hw || a;
+        std::fprintf(out, "PerfScope report%s\n",
+                     any_hw ? "" : " (hardware counters unavailable: perf_event_open denied or no PMU)");
+        std::fprintf(out, "%-10s %-24s %10s %12s %12s %12s %6s %12s %12s %10s\n", "thread", "section", "calls",
+                     "wall us/call", "cycles/call", "instr/call", "IPC", "cache-miss", "branch-miss", "ctx-sw");
+
+        PerfSections all;
+        std::map<std::string, int> seen_in;
+        for (const auto& t : threads) {
+            char label[24];
+            std::snprintf(label, sizeof(label), "%ld", t.tid);
+            for (const auto& [name, totals] : t.sections) {
+                print_row(out, label, name, totals);
+                all[name].add(totals);
+                ++seen_in[name];
+            }
+        }
+        // Sums only for sections that more than one thread ran.
+        for (const auto& [name, totals] : all)
+            if (seen_in[name] > 1) print_row(out, "all", name, totals);
+    }
+
+private:
+    struct ThreadEntry {
+        long tid;
+        PerfSections sections;
+    };
+
+    mutable std::mutex mtx;
+    std::vector<ThreadEntry> threads;
+    std::array<bool, PERF_HW_EVENTS> available{};
+
+    void print_row(std::FILE* out, const char* thread, const std::string& name, const PerfTotals& t) const {
+        double calls = t.calls ? static_cast<double>(t.calls) : 1.0;
+        auto per_call = [&](int e, char* buf, std::size_t n) {
+            if (e < PERF_HW_EVENTS && !available[e]) std::snprintf(buf, n, "n/a");
+            else std::snprintf(buf, n, "%.1f", t.events[e] / calls);
+            return buf;
+        };
+        char cyc[24], ins[24], cm[24], bm[24], ipc[16];
+        if (available[PERF_CYCLES] && available[PERF_INSTRUCTIONS] && t.events[PERF_CYCLES])
+            std::snprintf(ipc, sizeof(ipc), "%.2f", static_cast<double>(t.events[PERF_INSTRUCTIONS]) / t.events[PERF_CYCLES]);
+        else
+            std::snprintf(ipc, sizeof(ipc), "n/a");
+        std::fprintf(out, "%-10s %-24s %10llu %12.3f %12s %12s %6s %12s %12s %10llu\n", thread, name.c_str(),
+                     static_cast<unsigned long long>(t.calls), t.wall_ns / calls / 1e3,
+                     per_call(PERF_CYCLES, cyc, sizeof(cyc)), per_call(PERF_INSTRUCTIONS, ins, sizeof(ins)), ipc,
+                     per_call(PERF_CACHE_MISSES, cm, sizeof(cm)), per_call(PERF_BRANCH_MISSES, bm, sizeof(bm)),
+                     static_cast<unsigned long long>(t.events[PERF_CONTEXT_SWITCHES]));
+    }
+};
+
+namespace detail {
+
+// Counters and section totals of the calling thread.
+class ThreadPerf {
+public:
+    ThreadPerf() {
+        PerfRegistry::instance(); // Constructed first, so it outlives every thread's totals
+#ifdef __linux__
+        const std::pair<uint32_t, uint64_t> events[PERF_EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},     {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}};
+        tid = static_cast<long>(syscall(SYS_gettid));
+        // The first event that opens leads the group; the rest join it if they can. Context
+        // switches only ride along in a hardware group, where they come with the same read
+        // (on their own a getrusage() is the cheaper syscall). They happen in the kernel, so
+        // that event counts kernel side, which perf_event_paranoid may refuse.
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (e == PERF_CONTEXT_SWITCHES && leader < 0) break;
+            int group_fd = leader >= 0 ? counters[leader].descriptor() : -1;
+            PerfCounter c(events[e].first, events[e].second, group_fd, PERF_FORMAT_GROUP, e != PERF_CONTEXT_SWITCHES);
+            if (!c.valid()) continue;
+            if (leader < 0) leader = e;
+            slot[e] = members++;
+            counters[e] = std::move(c);
+        }
+        if (leader >= 0) counters[leader].start();
+#endif
+        for (int e = 0; e < PERF_HW_EVENTS; ++e) valid[e] = slot[e] >= 0;
+    }
+
+    ~ThreadPerf() { flush(); }
+
+    void snapshot(std::array<uint64_t, PERF_EVENT_COUNT>& out) const {
+        uint64_t values[PERF_EVENT_COUNT] = {};
+        std::size_t n = leader >= 0 ? counters[leader].read_group(values, PERF_EVENT_COUNT) : 0;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e)
+            out[e] = slot[e] >= 0 && static_cast<std::size_t>(slot[e]) < n ? values[slot[e]] : 0;
+#ifdef __linux__
+        if (slot[PERF_CONTEXT_SWITCHES] < 0) {
+            rusage ru{};
+            if (getrusage(RUSAGE_THREAD, &ru) == 0) out[PERF_CONTEXT_SWITCHES] = ru.ru_nvcsw + ru.ru_nivcsw;
+        }
+#endif
+    }
+
+    // Keyed by the literal's address: a call site always passes the same pointer.
+    PerfTotals& section(const char* name) {
+        for (auto& [key, totals] : sections)
+            if (key == name) return totals;
+        return sections.emplace_back(name, PerfTotals{}).second;
+    }
+
+    void flush() {
+        PerfSections by_name;
+        for (const auto& [key, totals] : sections) by_name[key].add(totals);
+        PerfRegistry::instance().merge(tid, valid, by_name);
+        sections.clear();
+    }
+
+private:
+    std::array<PerfCounter, PERF_EVENT_COUNT> counters;
+    std::array<int, PERF_EVENT_COUNT> slot = {-1, -1, -1, -1, -1}; // Position in the group read, -1 if not open
+    std::array<bool, PERF_HW_EVENTS> valid{};
+    std::vector<std::pair<const char*, PerfTotals>> sections;
+    int leader = -1;
+    int members = 0;
+    long tid = 0;
+};
+
+inline ThreadPerf& thread_perf() {
+    thread_local ThreadPerf perf;
+    return perf;
+}
+
+} // namespace detail
+
+class PerfScope {
+public:
+    explicit PerfScope(const char* section) : perf(detail::thread_perf()), name(section) {
+        perf.snapshot(begin);
+        t0 = std::chrono::steady_clock::now();
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    ~PerfScope() {
+        auto t1 = std::chrono::steady_clock::now();
+        std::array<uint64_t, PERF_EVENT_COUNT> end;
+        perf.snapshot(end);
+        PerfTotals& totals = perf.section(name);
+        ++totals.calls;
+        totals.wall_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) totals.events[e] += end[e] - begin[e];
+    }
+
+private:
+    detail::ThreadPerf& perf;
+    const char* name;
+    std::array<uint64_t, PERF_EVENT_COUNT> begin;
+    std::chrono::steady_clock::time_point t0;
+};
+
+// Hand the calling thread's totals to the report now instead of at thread exit.
+inline void perf_flush_thread() { detail::thread_perf().flush(); }
+
+// Print every section of every thread that has exited or flushed, plus the caller's.
+inline void perf_report(std::FILE* out = stdout) {
+    perf_flush_thread();
+    PerfRegistry::instance().print(out);
+}
+
+} // namespace perf_utils
+
+#endif // PERF_COUNTERS_H
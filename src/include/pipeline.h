@@ -0,0 +1,475 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "cpu_relax.h"
+#include "inplace_function.h"
+#include "latency_histogram.h"
+#include "rt_thread.h"
+#include "spsc_ring.h"
+
+namespace pipeline {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+// An item on an edge, stamped with the time its source produced the reading it derives
+// from; sinks measure end-to-end latency against it.
+template <typename T>
+struct Envelope {
+    T value;
+    Clock::time_point origin;
+};
+
+// Where a stage runs: on a thread of its own (optionally pinned / real-time through
+// rt_utils::ThreadConfig) or on the pipeline's shared worker pool.
+struct Placement {
+    bool dedicated = false;
+    rt_utils::ThreadConfig thread;
+
+    static Placement pool() { return {}; }
+    static Placement own_thread(rt_utils::ThreadConfig cfg = {}) { return {true, std::move(cfg)}; }
+    static Placement pinned(int cpu) {
+        rt_utils::ThreadConfig cfg;
+        cfg.cpu = cpu;
+        return {true, std::move(cfg)};
+    }
+};
+
+// How an idle runner waits for work: spin with cpu_relax(), then yield, then sleep for
+// at most `sleep` (or until the next source release, whichever is sooner).
+struct Backoff {
+    int spins = 64;
+    int yields = 16;
+    Clock::duration sleep = 50us;
+};
+
+// Written only by the thread currently running the stage; read them after stop().
+struct StageStats {
+    uint64_t in = 0;      // Items taken from inputs (sources: readings produced)
+    uint64_t out = 0;     // Items emitted (counted once, however many outputs)
+    uint64_t dropped = 0; // Source readings an output edge had no room for, per edge
+    uint64_t depth_samples = 0;
+    uint64_t depth_sum = 0;
+    std::size_t depth_max = 0;          // Items queued on the inputs when the stage picked up work
+    perf_utils::LatencyHistogram service; // Time in the stage function, per item
+    perf_utils::LatencyHistogram latency; // Sinks: source origin -> sink done
+
+    double busy_seconds() const { return service.mean() * static_cast<double>(service.count()) / 1e9; }
+    double mean_depth() const { return depth_samples ? static_cast<double>(depth_sum) / depth_samples : 0.0; }
+};
+
+class StageBase {
+public:
+    StageBase(std::string name, Placement placement) : name(std::move(name)), placement(std::move(placement)) {}
+    virtual ~StageBase() = default;
+
+    // Process up to BATCH items; false if there was nothing to do.
+    virtual bool poll() = 0;
+    // Next time the stage has work regardless of its inputs (periodic sources).
+    virtual Clock::time_point next_release() const { return Clock::time_point::max(); }
+    // Nothing queued on any input (approximate while upstream stages run).
+    virtual bool drained() const { return true; }
+    virtual const char* kind() const = 0;
+
+    const std::string& stage_name() const { return name; }
+    const Placement& stage_placement() const { return placement; }
+    const StageStats& stats() const { return counters; }
+
+    static constexpr int BATCH = 32;
+
+protected:
+    template <std::size_t>
+    friend class Pipeline;
+
+    void sample_depth(std::size_t depth) {
+        ++counters.depth_samples;
+        counters.depth_sum += depth;
+        counters.depth_max = std::max(counters.depth_max, depth);
+    }
+
+    std::string name;
+    Placement placement;
+    StageStats counters;
+    std::atomic_flag running = ATOMIC_FLAG_INIT; // Held by the runner executing poll()
+    std::atomic<bool> accepting{true};           // Sources stop producing once cleared
+};
+
+// Lock-free pipeline of typed stages.
+//
+// Every connect() creates its own SpscRing (EdgeCapacity slots), so each edge has exactly
+// one producing and one consuming stage and no locks are taken on the data path:
+//   - fan-out: connect one stage to several; every output receives a copy of each item.
+//   - fan-in: connect several stages to one; the stage always takes the oldest item (by
+//     source origin) at the front of its inputs, so readings from different sensors
+//     reach e.g. a FusionEngine in timestamp order as long as the upstream stages keep
+//     up. One that arrives after a newer item was taken is still delivered (and counted
+//     late by FusionEngine).
+// A stage on the shared pool can be picked up by any pool worker, but only by one at a
+// time, so its edges keep a single consumer and a single producer.
+//
+// Back-pressure: transform stages only take an input once every output has room, so
+// nothing is lost between stages and a slow stage fills its input edge (visible as queue
+// depth). Sources never wait: a reading an output has no room for is dropped and
+// counted, like BoundedBuffer's drop_newest.
+//
+//   pipeline::Pipeline<> p;
+//   auto& gps = p.source<fusion::SensorData>("gps", 100us, [&]() { return read_gps(); });
+//   auto& fuse = p.stage<fusion::SensorData, fusion::StateEstimate>("fusion", fuse_fn);
+//   auto& ctl = p.sink<fusion::StateEstimate>("control", control_fn, Placement::pinned(2));
+//   p.connect(gps, fuse);
+//   p.connect(fuse, ctl);
+//   p.start(1);          // Stages not on their own thread share one pool worker
+//   ...
+//   p.stop();
+//   p.report();
+template <std::size_t EdgeCapacity = 1024>
+class Pipeline {
+public:
+    template <typename T>
+    using Edge = sync_utils::SpscRing<Envelope<T>, EdgeCapacity>;
+
+    // Output side of a source or stage.
+    template <typename Out>
+    class Producer {
+    public:
+        std::size_t output_count() const { return outputs.size(); }
+
+    protected:
+        friend class Pipeline;
+
+        // Producer side: size() only overestimates, so a free slot seen here stays free.
+        bool outputs_have_space() {
+            for (auto* e : outputs)
+                if (e->size() >= EdgeCapacity) return false;
+            return true;
+        }
+
+        // Returns the number of outputs that had no room.
+        uint64_t emit(Out&& value, Clock::time_point origin) {
+            uint64_t full = 0;
+            for (std::size_t i = 0; i + 1 < outputs.size(); ++i)
+                full += outputs[i]->try_emplace(Envelope<Out>{value, origin}) ? 0 : 1;
+            if (!outputs.empty()) full += outputs.back()->try_emplace(Envelope<Out>{std::move(value), origin}) ? 0 : 1;
+            return full;
+        }
+
+        std::vector<Edge<Out>*> outputs;
+    };
+
+    // Input side of a stage or sink. Owns its input edges.
+    template <typename In>
+    class Consumer {
+    public:
+        std::size_t input_count() const { return inputs.size(); }
+
+    protected:
+        friend class Pipeline;
+
+        // Oldest item at the front of any input, or nullptr; `which` gets its edge.
+        Envelope<In>* oldest(std::size_t& which) {
+            Envelope<In>* best = nullptr;
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                Envelope<In>* e = inputs[i]->front();
+                if (e && (!best || e->origin < best->origin)) {
+                    best = e;
+                    which = i;
+                }
+            }
+            return best;
+        }
+
+        std::size_t depth() const {
+            std::size_t d = 0;
+            for (const auto& e : inputs) d += e->size();
+            return d;
+        }
+
+        std::vector<std::unique_ptr<Edge<In>>> inputs;
+    };
+
+    // Calls `produce` once per `period` (on absolute release times, catching up after a
+    // late wake-up) or, with period 0, on every poll; std::nullopt means no reading.
+    template <typename Out>
+    class Source : public StageBase, public Producer<Out> {
+    public:
+        using Fn = func_utils::InplaceFunction<std::optional<Out>(), 64>;
+
+        Source(std::string name, Clock::duration period, Fn produce, Placement placement)
+            : StageBase(std::move(name), std::move(placement)), period(period), produce(std::move(produce)) {}
+
+        bool poll() override {
+            if (!accepting.load(std::memory_order_relaxed)) return false;
+            int done = 0;
+            Clock::time_point now = Clock::now();
+            if (release == Clock::time_point{}) release = now;
+            while (done < BATCH && now >= release) {
+                std::optional<Out> reading = produce();
+                Clock::time_point end = Clock::now();
+                counters.service.record(end - now);
+                release = period.count() > 0 ? release + period : end;
+                ++done;
+                if (reading) {
+                    ++counters.in;
+                    ++counters.out;
+                    counters.dropped += this->emit(std::move(*reading), now);
+                } else if (period.count() == 0) {
+                    break; // Nothing to read: let the runner back off
+                }
+                now = end;
+            }
+            published_release.store(release.time_since_epoch().count(), std::memory_order_relaxed);
+            return done > 0;
+        }
+
+        // May be read by a pool worker while another one polls the source.
+        Clock::time_point next_release() const override {
+            if (period.count() == 0 || !accepting.load(std::memory_order_relaxed)) return Clock::time_point::max();
+            return Clock::time_point(Clock::duration(published_release.load(std::memory_order_relaxed)));
+        }
+
+        const char* kind() const override { return "source"; }
+
+    private:
+        Clock::duration period;
+        Fn produce;
+        Clock::time_point release{};
+        std::atomic<Clock::rep> published_release{0};
+    };
+
+    // Maps each input item to at most one output item (std::nullopt filters it out).
+    template <typename In, typename Out>
+    class Stage : public StageBase, public Consumer<In>, public Producer<Out> {
+    public:
+        using Fn = func_utils::InplaceFunction<std::optional<Out>(const In&), 64>;
+
+        Stage(std::string name, Fn transform, Placement placement)
+            : StageBase(std::move(name), std::move(placement)), transform(std::move(transform)) {}
+
+        bool poll() override {
+            int done = 0;
+            std::size_t which = 0;
+            while (done < BATCH && this->outputs_have_space()) {
+                Envelope<In>* item = this->oldest(which);
+                if (!item) break;
+                if (done == 0) sample_depth(this->depth());
+                Clock::time_point t0 = Clock::now();
+                std::optional<Out> result = transform(item->value);
+                counters.service.record(Clock::now() - t0);
+                Clock::time_point origin = item->origin;
+                this->inputs[which]->pop();
+                ++counters.in;
+                ++done;
+                if (result) {
+                    ++counters.out;
+                    this->emit(std::move(*result), origin); // Space checked above
+                }
+            }
+            return done > 0;
+        }
+
+        bool drained() const override { return this->depth() == 0; }
+        const char* kind() const override { return "stage"; }
+
+    private:
+        Fn transform;
+    };
+
+    // Consumes items at the end of the chain (an actuator, a logger) and records
+    // end-to-end latency.
+    template <typename In>
+    class Sink : public StageBase, public Consumer<In> {
+    public:
+        using Fn = func_utils::InplaceFunction<void(const In&), 64>;
+
+        Sink(std::string name, Fn consume, Placement placement)
+            : StageBase(std::move(name), std::move(placement)), consume(std::move(consume)) {}
+
+        bool poll() override {
+            int done = 0;
+            std::size_t which = 0;
+            while (done < BATCH) {
+                Envelope<In>* item = this->oldest(which);
+                if (!item) break;
+                if (done == 0) sample_depth(this->depth());
+                Clock::time_point t0 = Clock::now();
+                consume(item->value);
+                Clock::time_point t1 = Clock::now();
+                counters.service.record(t1 - t0);
+                counters.latency.record(t1 - item->origin);
+                this->inputs[which]->pop();
+                ++counters.in;
+                ++done;
+            }
+            return done > 0;
+        }
+
+        bool drained() const override { return this->depth() == 0; }
+        const char* kind() const override { return "sink"; }
+
+    private:
+        Fn consume;
+    };
+
+    explicit Pipeline(Backoff backoff = {}) : backoff(backoff) {}
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+    ~Pipeline() { halt(); }
+
+    template <typename Out, typename F>
+    Source<Out>& source(std::string name, Clock::duration period, F&& produce, Placement placement = Placement::pool()) {
+        return add(std::make_unique<Source<Out>>(std::move(name), period, std::forward<F>(produce), std::move(placement)));
+    }
+
+    template <typename In, typename Out, typename F>
+    Stage<In, Out>& stage(std::string name, F&& transform, Placement placement = Placement::pool()) {
+        return add(std::make_unique<Stage<In, Out>>(std::move(name), std::forward<F>(transform), std::move(placement)));
+    }
+
+    template <typename In, typename F>
+    Sink<In>& sink(std::string name, F&& consume, Placement placement = Placement::pool()) {
+        return add(std::make_unique<Sink<In>>(std::move(name), std::forward<F>(consume), std::move(placement)));
+    }
+
+    // Add an edge from `from` to `to`. Only before start().
+    template <typename T>
+    void connect(Producer<T>& from, Consumer<T>& to) {
+        to.inputs.push_back(std::make_unique<Edge<T>>());
+        from.outputs.push_back(to.inputs.back().get());
+    }
+
+    // Start one thread per dedicated stage and `pool_threads` workers (configured by
+    // `pool_config`, named "pool-<i>" unless it has a name) for the rest.
+    void start(int pool_threads = 1, rt_utils::ThreadConfig pool_config = {}) {
+        std::vector<StageBase*> pooled;
+        for (auto& s : stages) {
+            if (!s->placement.dedicated) {
+                pooled.push_back(s.get());
+                continue;
+            }
+            rt_utils::ThreadConfig cfg = s->placement.thread;
+            if (cfg.name.empty()) cfg.name = s->name;
+            threads.push_back(rt_utils::make_jthread(cfg, [this, stage = s.get()](std::stop_token st) {
+                run(st, std::vector<StageBase*>{stage}, 0);
+            }));
+        }
+        if (!pooled.empty()) {
+            for (int i = 0; i < std::max(pool_threads, 1); ++i) {
+                rt_utils::ThreadConfig cfg = pool_config;
+                if (cfg.name.empty()) cfg.name = "pool-" + std::to_string(i);
+                threads.push_back(rt_utils::make_jthread(cfg, [this, pooled, i](std::stop_token st) {
+                    run(st, pooled, static_cast<std::size_t>(i));
+                }));
+            }
+        }
+        started = Clock::now();
+    }
+
+    // Stop the sources, give the rest up to `drain` to empty their inputs, then stop and
+    // join every thread. The measured run ends after the join: stages keep counting the
+    // items they drain, so report() divides them by a time that includes the drain (and
+    // busy% cannot exceed 100%).
+    void stop(Clock::duration drain = 100ms) {
+        for (auto& s : stages) s->accepting.store(false, std::memory_order_relaxed);
+        auto deadline = Clock::now() + drain;
+        while (Clock::now() < deadline &&
+               !std::all_of(stages.begin(), stages.end(), [](const auto& s) { return s->drained(); }))
+            std::this_thread::sleep_for(1ms);
+        halt();
+    }
+
+    // Per-stage throughput, load, service time and input depth, then end-to-end latency
+    // at each sink. The busiest stage is marked: it is the one to speed up, split or move
+    // to its own core. Call after stop().
+    void report(std::FILE* out = stdout) const {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        const StageBase* busiest = nullptr;
+        for (const auto& s : stages)
+            if (!busiest || s->counters.busy_seconds() > busiest->counters.busy_seconds()) busiest = s.get();
+        std::fprintf(out, "%-12s %-7s %-8s %10s %10s %9s %7s %9s %9s %7s %7s\n", "stage", "kind", "thread", "in/s",
+                     "out/s", "dropped", "busy%", "svc p50us", "svc p99us", "depth", "max");
+        for (const auto& s : stages) {
+            const StageStats& c = s->counters;
+            std::fprintf(out, "%-12s %-7s %-8s %10.0f %10.0f %9llu %6.1f%% %9.2f %9.2f %7.1f %7zu%s\n",
+                         s->name.c_str(), s->kind(), s->placement.dedicated ? "own" : "pool",
+                         seconds > 0 ? c.in / seconds : 0.0, seconds > 0 ? c.out / seconds : 0.0,
+                         static_cast<unsigned long long>(c.dropped), seconds > 0 ? 100.0 * c.busy_seconds() / seconds : 0.0,
+                         c.service.percentile(50) / 1e3, c.service.percentile(99) / 1e3, c.mean_depth(), c.depth_max,
+                         s.get() == busiest ? "  <- busiest" : "");
+        }
+        for (const auto& s : stages) {
+            const auto& h = s->counters.latency;
+            if (h.count() == 0) continue;
+            std::fprintf(out, "end-to-end at %-12s p50 %8.1fus  p99 %8.1fus  p99.9 %8.1fus  max %8.1fus  (%llu items)\n",
+                         s->name.c_str(), h.percentile(50) / 1e3, h.percentile(99) / 1e3, h.percentile(99.9) / 1e3,
+                         h.max() / 1e3, static_cast<unsigned long long>(h.count()));
+        }
+    }
+
+    const std::vector<std::unique_ptr<StageBase>>& all_stages() const { return stages; }
+    Clock::duration run_time() const { return elapsed; }
+
+private:
+    template <typename S>
+    S& add(std::unique_ptr<S> stage) {
+        S& ref = *stage;
+        stages.push_back(std::move(stage));
+        return ref;
+    }
+
+    // Runner loop: poll each stage it may run (skipping ones another pool worker holds),
+    // starting at `first` so pool workers spread out, and back off when none had work.
+    void run(std::stop_token st, std::vector<StageBase*> mine, std::size_t first) {
+        int idle = 0;
+        while (!st.stop_requested()) {
+            bool progressed = false;
+            for (std::size_t k = 0; k < mine.size(); ++k) {
+                StageBase* s = mine[(first + k) % mine.size()];
+                if (s->running.test_and_set(std::memory_order_acquire)) continue;
+                progressed |= s->poll();
+                s->running.clear(std::memory_order_release);
+            }
+            if (progressed) {
+                idle = 0;
+            } else if (idle < backoff.spins) {
+                ++idle;
+                sync_utils::cpu_relax();
+            } else if (idle < backoff.spins + backoff.yields) {
+                ++idle;
+                std::this_thread::yield();
+            } else {
+                Clock::time_point wake = Clock::now() + backoff.sleep;
+                for (StageBase* s : mine) wake = std::min(wake, s->next_release());
+                std::this_thread::sleep_until(wake);
+            }
+        }
+    }
+
+    void halt() {
+        threads.clear(); // Requests stop and joins; no stage runs past this point
+        if (started != Clock::time_point{}) elapsed = Clock::now() - started;
+        started = {};
+    }
+
+    Backoff backoff;
+    std::vector<std::unique_ptr<StageBase>> stages;
+    std::vector<std::jthread> threads;
+    Clock::time_point started{};
+    Clock::duration elapsed{};
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_H
@@ -0,0 +1,159 @@
+#ifndef PLANT_SIM_H
+#define PLANT_SIM_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace control {
+
+// Linear plant with optional transport delay and sensor noise.
+//   First order:  tau * y' + y = K * u
+//   Second order: y'' + 2 * zeta * wn * y' + wn^2 * y = wn^2 * K * u
+// The input is held constant over each fixed step (zero-order hold) and the state is
+// advanced with RK4, so results do not depend on how fast the caller steps it. The
+// sensor sees the output `dead_time` later, plus Gaussian noise from a seeded generator:
+// two simulations with the same config and inputs are bit-identical.
+struct PlantConfig {
+    enum Order { FirstOrder = 1, SecondOrder = 2 };
+
+    Order order = FirstOrder;
+    double gain = 1.0;         // K
+    double time_constant = 1.0; // tau [s], first order
+    double natural_freq = 2.0;  // wn [rad/s], second order
+    double damping = 0.5;       // zeta, second order
+    double dead_time = 0.0;     // Sensor transport delay [s]
+    double noise_stddev = 0.0;  // Measurement noise
+    double dt = 1e-3;           // Physics step [s]
+    uint32_t seed = 1;
+};
+
+class PlantSim {
+public:
+    explicit PlantSim(const PlantConfig& config)
+        : cfg(config),
+          delay_line(static_cast<std::size_t>(std::lround(config.dead_time / config.dt)) + 1, 0.0),
+          rng(config.seed),
+          noise(0.0, config.noise_stddev > 0.0 ? config.noise_stddev : 1.0) {}
+
+    // Advance one physics step with input u held constant.
+    void step(double u) {
+        auto deriv = [&](const State& s) -> State {
+            if (cfg.order == PlantConfig::FirstOrder) return {(cfg.gain * u - s.y) / cfg.time_constant, 0.0};
+            double wn = cfg.natural_freq;
+            return {s.v, wn * wn * (cfg.gain * u - s.y) - 2.0 * cfg.damping * wn * s.v};
+        };
+        const double h = cfg.dt;
+        State k1 = deriv(x);
+        State k2 = deriv({x.y + 0.5 * h * k1.y, x.v + 0.5 * h * k1.v});
+        State k3 = deriv({x.y + 0.5 * h * k2.y, x.v + 0.5 * h * k2.v});
+        State k4 = deriv({x.y + h * k3.y, x.v + h * k3.v});
+        x.y += h / 6.0 * (k1.y + 2.0 * k2.y + 2.0 * k3.y + k4.y);
+        x.v += h / 6.0 * (k1.v + 2.0 * k2.v + 2.0 * k3.v + k4.v);
+
+        delay_line[head] = x.y;
+        head = (head + 1) % delay_line.size();
+        ++steps;
+    }
+
+    // True plant output now.
+    double output() const { return x.y; }
+
+    // What the sensor reports now: the output dead_time ago, plus noise.
+    double measure() {
+        double delayed = delay_line[head]; // Oldest entry in the line
+        return cfg.noise_stddev > 0.0 ? delayed + noise(rng) : delayed;
+    }
+
+    double time() const { return static_cast<double>(steps) * cfg.dt; }
+    uint64_t step_count() const { return steps; }
+    const PlantConfig& config() const { return cfg; }
+
+private:
+    struct State {
+        double y;
+        double v; // dy/dt, second order only
+    };
+
+    PlantConfig cfg;
+    State x{0.0, 0.0};
+    std::vector<double> delay_line; // Ring of the last dead_time / dt outputs
+    std::size_t head = 0;
+    uint64_t steps = 0;
+    std::mt19937 rng;
+    std::normal_distribution<double> noise;
+};
+
+// PID with output limits and conditional integration (the integrator freezes while the
+// output is saturated in the direction of the error, so it does not wind up during the
+// dead time).
+class PidController {
+public:
+    PidController(double kp, double ki, double kd, double dt,
+                  double out_min = -std::numeric_limits<double>::infinity(),
+                  double out_max = std::numeric_limits<double>::infinity())
+        : kp(kp), ki(ki), kd(kd), dt(dt), out_min(out_min), out_max(out_max) {}
+
+    double compute(double setpoint, double measurement) {
+        double error = setpoint - measurement;
+        double derivative = first ? 0.0 : (error - prev_error) / dt;
+        first = false;
+        prev_error = error;
+        double candidate = integral + error * dt;
+        double u = kp * error + ki * candidate + kd * derivative;
+        double clamped = std::clamp(u, out_min, out_max);
+        if (clamped == u || (u > out_max && error < 0.0) || (u < out_min && error > 0.0)) integral = candidate;
+        return clamped;
+    }
+
+    void reset() {
+        integral = prev_error = 0.0;
+        first = true;
+    }
+
+private:
+    double kp, ki, kd, dt, out_min, out_max;
+    double integral = 0.0;
+    double prev_error = 0.0;
+    bool first = true;
+};
+
+// Step-response quality of a trace sampled every `dt` after a step from 0 to `setpoint`.
+struct StepMetrics {
+    double rise_time = NAN;     // 10% -> 90% of the setpoint [s]
+    double overshoot_pct = 0.0; // Peak above the setpoint, percent of the setpoint
+    double settling_time = NAN; // Last exit from the +-band around the setpoint [s]; NaN if never settles
+    double steady_state_error = 0.0; // Mean error over the last 10% of the trace
+};
+
+inline StepMetrics analyze_step(const std::vector<double>& trace, double setpoint, double dt, double band = 0.02) {
+    StepMetrics m;
+    if (trace.empty() || setpoint == 0.0) return m;
+    double t10 = NAN, peak = trace[0];
+    std::size_t last_outside = trace.size();
+    for (std::size_t i = 0; i < trace.size(); ++i) {
+        double y = trace[i];
+        peak = std::max(peak, y);
+        if (std::isnan(t10) && y >= 0.1 * setpoint) t10 = i * dt;
+        if (std::isnan(m.rise_time) && y >= 0.9 * setpoint && !std::isnan(t10)) m.rise_time = i * dt - t10;
+        if (std::fabs(y - setpoint) > band * std::fabs(setpoint)) last_outside = i;
+    }
+    m.overshoot_pct = std::max(0.0, (peak - setpoint) / setpoint * 100.0);
+    if (last_outside == trace.size()) m.settling_time = 0.0;
+    else if (last_outside + 1 < trace.size()) m.settling_time = (last_outside + 1) * dt;
+
+    std::size_t tail = std::max<std::size_t>(1, trace.size() / 10);
+    double sum = 0.0;
+    for (std::size_t i = trace.size() - tail; i < trace.size(); ++i) sum += setpoint - trace[i];
+    m.steady_state_error = sum / static_cast<double>(tail);
+    return m;
+}
+
+} // namespace control
+
+#endif // PLANT_SIM_H
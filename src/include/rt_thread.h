@@ -0,0 +1,272 @@
+#ifndef RT_THREAD_H
+#define RT_THREAD_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rt_utils {
+
+// How a real-time thread should run. Every field defaults to "leave as is", so a default
+// ThreadConfig is an ordinary thread.
+//
+//   rt_utils::ThreadConfig cfg;
+//   cfg.name = "controller";
+//   cfg.cpu = 2;
+//   cfg.policy = rt_utils::Policy::Fifo;
+//   cfg.priority = 80;
+//   cfg.prefault_stack = 256 * 1024;
+//   cfg.lock_memory = true;
+//   std::jthread controller = rt_utils::make_jthread(cfg, controlThread, std::ref(data));
+//
+// Scheduling classes and memory locking usually need CAP_SYS_NICE / CAP_IPC_LOCK (or
+// RLIMIT_RTPRIO / RLIMIT_MEMLOCK). Anything the kernel refuses is skipped: the thread
+// still runs, as SCHED_OTHER on any CPU if need be, and the refusal is returned in
+// applied(). The first refusal of each kind (affinity, mlockall, each policy) in the
+// process is also printed on stderr, so a run without privileges is never silently
+// "real-time" and a pool of identical threads prints one line, not one per thread.
+enum class Policy { Other, Fifo, RoundRobin, Deadline };
+
+struct ThreadConfig {
+    std::string name;                  // pthread_setname_np; truncated to 15 characters
+    int cpu = -1;                      // Pin to this CPU; -1 keeps the inherited affinity
+    Policy policy = Policy::Other;
+    int priority = 0;                  // 1..99 for Fifo / RoundRobin
+    std::chrono::nanoseconds runtime{};  // Deadline: budget per period
+    std::chrono::nanoseconds deadline{}; // Deadline: relative deadline (0 = period)
+    std::chrono::nanoseconds period{};   // Deadline: period
+    std::size_t prefault_stack = 0;    // Bytes of stack to touch before running
+    bool lock_memory = false;          // mlockall(MCL_CURRENT | MCL_FUTURE), process-wide
+    bool report = true;                // Print refused settings to stderr
+};
+
+// What apply() managed to set on the calling thread.
+struct Applied {
+    bool named = false;
+    bool pinned = false;
+    bool scheduled = false; // Requested policy is in effect (always true for Policy::Other)
+    const char* policy = "SCHED_OTHER"; // Policy in effect
+    bool locked = false;
+    bool prefaulted = false;
+    std::string refused;    // "SCHED_FIFO(EPERM) mlockall(ENOMEM)", empty if nothing was refused
+
+    void describe(char* buf, std::size_t n) const {
+        std::snprintf(buf, n, "%s %s%s%s%s", policy, pinned ? "pinned " : "",
+                      locked ? "mlocked " : "", prefaulted ? "prefaulted " : "",
+                      refused.empty() ? "" : ("refused: " + refused).c_str());
+    }
+};
+
+namespace detail {
+
+inline thread_local Applied applied_here;
+
+enum RefusalKind : unsigned {
+    REFUSED_AFFINITY = 1u << 0,
+    REFUSED_MLOCK = 1u << 1,
+    REFUSED_FIFO = 1u << 2,
+    REFUSED_RR = 1u << 3,
+    REFUSED_DEADLINE = 1u << 4,
+    REFUSED_PLATFORM = 1u << 5,
+};
+
+// Refusal kinds already printed by any thread.
+inline std::atomic<unsigned> reported_refusals{0};
+
+// True if `kinds` includes one not reported before; marks them all reported.
+inline bool first_report(unsigned kinds) {
+    return (reported_refusals.fetch_or(kinds, std::memory_order_relaxed) & kinds) != kinds;
+}
+
+inline void note_refusal(Applied& a, unsigned& kinds, unsigned kind, const char* what, int err) {
+    kinds |= kind;
+    if (!a.refused.empty()) a.refused += ' ';
+    a.refused += what;
+    a.refused += '(';
+    a.refused += err == EPERM ? "EPERM" : std::strerror(err);
+    a.refused += ')';
+}
+
+#ifdef __linux__
+// sched_setattr(2) has no glibc wrapper before 2.41; this is the kernel's layout.
+struct SchedAttr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+inline constexpr uint32_t SCHED_DEADLINE_POLICY = 6;
+
+inline int set_deadline(const ThreadConfig& cfg) {
+#ifdef SYS_sched_setattr
+    SchedAttr attr{};
+    attr.size = sizeof(attr);
+    attr.sched_policy = SCHED_DEADLINE_POLICY;
+    attr.sched_runtime = static_cast<uint64_t>(cfg.runtime.count());
+    attr.sched_period = static_cast<uint64_t>(cfg.period.count());
+    attr.sched_deadline = static_cast<uint64_t>(cfg.deadline.count() ? cfg.deadline.count() : cfg.period.count());
+    return syscall(SYS_sched_setattr, 0, &attr, 0) == 0 ? 0 : errno;
+#else
+    (void)cfg;
+    return ENOSYS;
+#endif
+}
+
+[[gnu::noinline]] inline void prefault_stack(std::size_t bytes) {
+    // Touch every page below the current frame so later growth does not page-fault.
+    auto* p = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (std::size_t i = 0; i < bytes; i += 4096) p[i] = 0;
+}
+#endif
+
+} // namespace detail
+
+// Apply `cfg` to the calling thread. Never fails: refused settings are recorded.
+inline Applied apply(const ThreadConfig& cfg) {
+    Applied a;
+    unsigned refused_kinds = 0;
+#ifdef __linux__
+    if (!cfg.name.empty()) a.named = pthread_setname_np(pthread_self(), cfg.name.substr(0, 15).c_str()) == 0;
+
+    if (cfg.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg.cpu, &set);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err == 0) a.pinned = true;
+        else detail::note_refusal(a, refused_kinds, detail::REFUSED_AFFINITY, "affinity", err);
+    }
+
+    if (cfg.lock_memory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) a.locked = true;
+        else detail::note_refusal(a, refused_kinds, detail::REFUSED_MLOCK, "mlockall", errno);
+    }
+
+    if (cfg.prefault_stack) {
+        detail::prefault_stack(cfg.prefault_stack);
+        a.prefaulted = true;
+    }
+
+    // Last, so the setup above does not run at real-time priority.
+    switch (cfg.policy) {
+    case Policy::Other:
+        a.scheduled = true;
+        break;
+    case Policy::Fifo:
+    case Policy::RoundRobin: {
+        sched_param sp{};
+        sp.sched_priority = cfg.priority;
+        int policy = cfg.policy == Policy::Fifo ? SCHED_FIFO : SCHED_RR;
+        int err = pthread_setschedparam(pthread_self(), policy, &sp);
+        const char* name = policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR";
+        if (err == 0) {
+            a.scheduled = true;
+            a.policy = name;
+        } else {
+            detail::note_refusal(a, refused_kinds, policy == SCHED_FIFO ? detail::REFUSED_FIFO : detail::REFUSED_RR,
+                                 name, err);
+        }
+        break;
+    }
+    case Policy::Deadline: {
+        int err = detail::set_deadline(cfg);
+        if (err == 0) {
+            a.scheduled = true;
+            a.policy = "SCHED_DEADLINE";
+        } else {
+            detail::note_refusal(a, refused_kinds, detail::REFUSED_DEADLINE, "SCHED_DEADLINE", err);
+        }
+        break;
+    }
+    }
+#else
+    (void)cfg;
+    a.scheduled = true;
+    a.refused = "unsupported platform";
+    refused_kinds = detail::REFUSED_PLATFORM;
+#endif
+    if (cfg.report && refused_kinds && detail::first_report(refused_kinds))
+        std::fprintf(stderr, "[rt] %s: %s (running with what was granted)\n",
+                     cfg.name.empty() ? "thread" : cfg.name.c_str(), a.refused.c_str());
+    detail::applied_here = a;
+    return a;
+}
+
+// What apply() set on the calling thread (all false if it never ran here).
+inline const Applied& applied() { return detail::applied_here; }
+
+// CPUs this process may run on (its affinity mask, e.g. as narrowed by taskset or a
+// cgroup), in ascending order: the values ThreadConfig::cpu can be pinned to.
+inline std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+    return cpus;
+}
+
+// Busy-wait for `d`: stands in for CPU work in a benchmarked task, without the timer
+// slack a sleep would add.
+inline void spin_for(std::chrono::steady_clock::duration d) {
+    auto end = std::chrono::steady_clock::now() + d;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// std::thread / std::jthread whose body first applies `cfg`. make_jthread passes the
+// stop_token on when the callable takes one as its first parameter, like std::jthread.
+template <typename F, typename... Args>
+std::thread make_thread(ThreadConfig cfg, F&& f, Args&&... args) {
+    return std::thread(
+        [cfg = std::move(cfg)](auto&& fn, auto&&... a) {
+            apply(cfg);
+            std::invoke(std::forward<decltype(fn)>(fn), std::forward<decltype(a)>(a)...);
+        },
+        std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <typename F, typename... Args>
+std::jthread make_jthread(ThreadConfig cfg, F&& f, Args&&... args) {
+    return std::jthread(
+        [cfg = std::move(cfg)](std::stop_token st, auto&& fn, auto&&... a) {
+            apply(cfg);
+            if constexpr (std::is_invocable_v<decltype(fn), std::stop_token, decltype(a)...>)
+                std::invoke(std::forward<decltype(fn)>(fn), std::move(st), std::forward<decltype(a)>(a)...);
+            else
+                std::invoke(std::forward<decltype(fn)>(fn), std::forward<decltype(a)>(a)...);
+        },
+        std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+} // namespace rt_utils
+
+#endif // RT_THREAD_H
@@ -0,0 +1,390 @@
+#ifndef SENSOR_FUSION_H
+#define SENSOR_FUSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "cache_padded.h"
+#include "fusion_engine.h"
+#include "latency_histogram.h"
+#include "sensor_log.h"
+#include "state_history.h"
+
+namespace fusion {
+
+// When the fusion thread runs. Periodic is the original fixed-interval polling; the other
+// modes are event driven: sensor threads bump an atomic sequence and the fusion thread
+// parks on it with atomic::wait, so it wakes only when there is something to fuse and
+// sensor -> state latency is bounded by a futex wake-up instead of the polling period.
+struct FusionTrigger {
+    enum class Mode {
+        Periodic,     // Every `period`, whether or not data arrived.
+        EveryReading, // As soon as any reading arrives.
+        Count,        // Once `count` readings are pending.
+        Quorum,       // Once `quorum` distinct sensors have reported since the last fusion.
+        Deadline,     // `period` after the oldest pending reading arrived.
+    };
+
+    Mode mode = Mode::Periodic;
+    std::size_t count = 1;
+    std::size_t quorum = 1;
+    steady_clock::duration period = std::chrono::milliseconds(200);
+
+    static FusionTrigger periodic(steady_clock::duration p) { return {Mode::Periodic, 1, 1, p}; }
+    static FusionTrigger every_reading() { return {Mode::EveryReading, 1, 1, {}}; }
+    static FusionTrigger every_n(std::size_t n) { return {Mode::Count, n, 1, {}}; }
+    static FusionTrigger quorum_of(std::size_t k) { return {Mode::Quorum, 1, k, {}}; }
+    static FusionTrigger deadline(steady_clock::duration d) { return {Mode::Deadline, 1, 1, d}; }
+};
+
+// Sensor fusion class to manage thread-safe data fusion (sensor_data_fusion_gk1.cpp).
+// Sensor threads append readings to a buffer; the fusion thread swaps the buffer out
+// and feeds it to an EKF FusionEngine in timestamp order.
+class SensorFusion {
+public:
+    using History = StateHistory<4096>;
+
+private:
+    static constexpr std::size_t READINGS_RESERVE = 1024;
+
+    // Members are grouped by the threads that write them, one group per cache line (or
+    // run of lines), so sensor threads appending readings do not keep invalidating the
+    // line the fusion thread's state or the running flag sits on.
+
+    // Set up before the threads start, then only read.
+    FusionTrigger trigger;
+    bool debug = true;
+    uint64_t seed = std::random_device{}();
+    steady_clock::time_point start = steady_clock::now();
+
+    // Written by the fusion thread; read by get_state() and friends.
+    alignas(sync_utils::CACHE_LINE) std::mutex state_mutex; // Mutex for thread-safe access
+    FusionEngine<2> engine; // Guarded by state_mutex
+    StateEstimate state; // Shared state estimate
+    perf_utils::LatencyHistogram latency; // Reading timestamp -> state updated (state_mutex)
+    std::vector<SensorData> fusing; // Batch being fused; swapped with sensor_readings
+    History history_ring; // Every published state; written by the fusion thread only
+
+    // Written by every sensor thread under readings_mutex.
+    alignas(sync_utils::CACHE_LINE) std::mutex readings_mutex; // Mutex for sensor readings buffer
+    std::vector<SensorData> sensor_readings; // Buffer for sensor data
+    std::vector<uint8_t> reported; // Sensors seen since the last fusion (readings_mutex)
+    std::size_t distinct_sensors = 0; // Count of set entries in `reported` (readings_mutex)
+    std::size_t max_pending = 0; // 0: unbounded buffer (readings_mutex)
+    uint64_t dropped = 0; // Readings rejected because the buffer was full (readings_mutex)
+    uint64_t unknown = 0; // Readings rejected for a sensor_id with no model (readings_mutex)
+    SensorLogWriter recorder; // Active while recording (readings_mutex)
+
+    // Polled by every thread / bumped by sensor threads and waited on by fusion.
+    sync_utils::CachePadded<std::atomic<bool>> running{true}; // Atomic flag to control thread execution
+    sync_utils::CachePadded<std::atomic<uint32_t>> wake_seq{0}; // Bumped when the trigger condition becomes true
+
+    // Ground truth the simulated sensors observe: a slow oscillation around 50.
+    double true_position(steady_clock::time_point t) const {
+        double s = std::chrono::duration<double>(t - start).count();
+        return 50.0 + 20.0 * std::sin(0.5 * s);
+    }
+
+    double true_velocity(steady_clock::time_point t) const {
+        double s = std::chrono::duration<double>(t - start).count();
+        return 10.0 * std::cos(0.5 * s);
+    }
+
+    // Simulate sensor reading: the truth seen through the sensor's model plus noise.
+    // Each sensor thread owns its generator, so there is no shared RNG state to race on.
+    SensorData read_sensor(const char* sensor_name, int sensor_id, std::mt19937& gen) {
+        const SensorModel& model = engine.model(sensor_id);
+        std::normal_distribution<> noise(0.0, model.noise_stddev);
+
+        SensorData data;
+        data.timestamp = steady_clock::now();
+        data.sensor_id = sensor_id;
+        double p = true_position(data.timestamp);
+        switch (model.kind) {
+        case MeasurementKind::Position: data.value = p; break;
+        case MeasurementKind::Velocity: data.value = true_velocity(data.timestamp); break;
+        case MeasurementKind::Range: data.value = std::sqrt(p * p + model.range_offset * model.range_offset); break;
+        }
+        data.value += noise(gen);
+        if (debug) {
+            std::printf("[DEBUG] Sensor %s (ID: %d) read value: %.2f at time %ld\n",
+                        sensor_name, sensor_id, data.value,
+                        data.timestamp.time_since_epoch().count());
+        }
+        return data;
+    }
+
+    // Caller holds readings_mutex.
+    bool trigger_ready() const {
+        switch (trigger.mode) {
+        case FusionTrigger::Mode::Periodic: return false;
+        case FusionTrigger::Mode::EveryReading: return !sensor_readings.empty();
+        case FusionTrigger::Mode::Count: return sensor_readings.size() >= trigger.count;
+        case FusionTrigger::Mode::Quorum: return distinct_sensors >= trigger.quorum;
+        case FusionTrigger::Mode::Deadline: return !sensor_readings.empty();
+        }
+        return false;
+    }
+
+    // Park until the trigger condition holds (or stop()). Returns false when stopping.
+    bool wait_for_trigger() {
+        for (;;) {
+            // Load the sequence before checking, so a bump after the check ends the wait.
+            uint32_t seq = wake_seq->load(std::memory_order_acquire);
+            if (!*running) return false;
+            steady_clock::time_point oldest{};
+            {
+                std::lock_guard<std::mutex> lock(readings_mutex);
+                if (trigger_ready()) {
+                    if (trigger.mode != FusionTrigger::Mode::Deadline) return true;
+                    oldest = sensor_readings.front().timestamp;
+                }
+            }
+            if (oldest != steady_clock::time_point{}) {
+                std::this_thread::sleep_until(oldest + trigger.period);
+                return *running;
+            }
+            wake_seq->wait(seq, std::memory_order_acquire);
+        }
+    }
+
+    void wake_fusion() {
+        wake_seq->fetch_add(1, std::memory_order_release);
+        wake_seq->notify_one();
+    }
+
+    bool known_sensor(int sensor_id) const {
+        return sensor_id >= 0 && static_cast<std::size_t>(sensor_id) < reported.size();
+    }
+
+    // Common entry for live and replayed readings: buffer, record, and trigger fusion.
+    // Returns false if the reading was dropped: unknown sensor_id, or max_pending readings
+    // are waiting.
+    bool ingest(const SensorData& data, const char* sensor_name) {
+        bool fire;
+        { // Store reading in buffer
+            std::lock_guard<std::mutex> lock(readings_mutex);
+            if (!known_sensor(data.sensor_id)) {
+                ++unknown;
+                return false;
+            }
+            if (max_pending != 0 && sensor_readings.size() >= max_pending) {
+                ++dropped;
+                return false;
+            }
+            bool was_ready = trigger_ready();
+            sensor_readings.push_back(data);
+            if (!reported[data.sensor_id]) {
+                reported[data.sensor_id] = 1;
+                ++distinct_sensors;
+            }
+            recorder.write(data);
+            // Wake only on the transition to ready; later readings ride along.
+            fire = !was_ready && trigger_ready();
+            if (debug) {
+                std::printf("[DEBUG] Sensor %s (ID: %d) stored reading, buffer size: %zu\n",
+                            sensor_name, data.sensor_id, sensor_readings.size());
+            }
+        }
+        if (fire) wake_fusion();
+        return true;
+    }
+
+    // Fuse buffered readings through the EKF and predict to the current time.
+    void fuse_data() {
+        {
+            std::lock_guard<std::mutex> lock(readings_mutex);
+            if (sensor_readings.empty()) {
+                if (debug) std::printf("[DEBUG] No sensor data to fuse\n");
+                return;
+            }
+            // Both vectors keep their capacity, so steady state never allocates.
+            std::swap(sensor_readings, fusing);
+            std::fill(reported.begin(), reported.end(), 0);
+            distinct_sensors = 0;
+        }
+
+        // Update shared state
+        {
+            std::lock_guard<std::mutex> state_lock(state_mutex);
+            engine.process(fusing);
+            state = engine.estimate_at(steady_clock::now());
+            history_ring.append(state);
+            auto done = steady_clock::now();
+            for (const auto& reading : fusing) latency.record(done - reading.timestamp);
+            if (debug) {
+                std::printf("[DEBUG] Fused state updated: value = %.2f (truth %.2f, var %.3f) at time %ld\n",
+                            state.fused_value, true_position(state.last_updated), state.variance,
+                            state.last_updated.time_since_epoch().count());
+            }
+        }
+        fusing.clear(); // Clear readings after fusion
+    }
+
+public:
+    // models[i] describes the sensor with ID i; process_noise is the acceleration noise density.
+    explicit SensorFusion(std::vector<SensorModel> models, double process_noise = 25.0,
+                          FusionTrigger trigger = FusionTrigger::periodic(std::chrono::milliseconds(200)))
+        : trigger(trigger), engine(std::move(models), process_noise), state{0.0, steady_clock::now()} {
+        sensor_readings.reserve(READINGS_RESERVE);
+        fusing.reserve(READINGS_RESERVE);
+        reported.assign(engine.sensor_count(), 0);
+    }
+
+    // Enable/disable the [DEBUG] trace (printing dominates latency at high rates).
+    void set_debug(bool on) { debug = on; }
+
+    // Bound the pending-readings buffer; when full, new readings are dropped and counted
+    // instead of growing the buffer without limit. 0 (the default) means unbounded.
+    void set_max_pending(std::size_t n) {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        max_pending = n;
+    }
+
+    // Seed for the simulated sensors; sensor i uses mt19937(seed, i). Call before starting threads.
+    void set_seed(uint64_t s) { seed = s; }
+
+    // Record every ingested reading to a binary log (see sensor_log.h).
+    bool start_recording(const char* path) {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        return recorder.open(path);
+    }
+
+    uint64_t stop_recording() {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        uint64_t records = recorder.record_count();
+        recorder.close();
+        return records;
+    }
+
+    // Sensor thread function.
+    void sensor_thread(const char* sensor_name, int sensor_id,
+                       steady_clock::duration period = std::chrono::milliseconds(100)) {
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                          static_cast<uint32_t>(sensor_id)};
+        std::mt19937 gen(seq);
+        if (!known_sensor(sensor_id)) { // read_sensor() needs its model
+            std::fprintf(stderr, "Sensor %s: no model for ID %d (%zu sensors)\n", sensor_name, sensor_id, reported.size());
+            return;
+        }
+        while (*running) {
+            // Simulate sensor reading.
+            ingest(read_sensor(sensor_name, sensor_id, gen), sensor_name);
+
+            // Simulate sensor processing delay.
+            std::this_thread::sleep_for(period);
+        }
+        if (debug) std::printf("[DEBUG] Sensor %s (ID: %d) thread stopped\n", sensor_name, sensor_id);
+    }
+
+    // Inject a reading produced outside the sensor threads (load generators, other
+    // processes). Returns false if it was dropped (unknown sensor or buffer full).
+    bool submit(const SensorData& data) {
+        return ingest(data, known_sensor(data.sensor_id) ? engine.model(data.sensor_id).name : "unknown");
+    }
+
+    // Feed a recorded log back in place of the sensor threads. Timestamps keep their
+    // recorded spacing (so the filter sees the same dynamics at any speed) and are anchored
+    // at the moment replay starts. speed 1.0 paces readings as recorded, > 1 accelerates,
+    // <= 0 injects as fast as possible. Latency histograms are only meaningful at 1.0.
+    void replay_thread(const std::vector<LoggedReading>& log, double speed = 1.0) {
+        auto base = steady_clock::now();
+        for (const auto& r : log) {
+            if (!*running) break;
+            auto offset = std::chrono::nanoseconds(r.t_ns);
+            if (speed > 0.0) {
+                std::this_thread::sleep_until(base + std::chrono::duration_cast<steady_clock::duration>(offset / speed));
+            }
+            submit({r.value, base + offset, r.sensor_id});
+        }
+        if (debug) std::printf("[DEBUG] Replay thread finished\n");
+    }
+
+    // Fusion thread function.
+    void fusion_thread() {
+        if (trigger.mode == FusionTrigger::Mode::Periodic) {
+            while (*running) {
+                fuse_data();
+                std::this_thread::sleep_for(trigger.period); // Fuse every period
+            }
+        } else {
+            while (wait_for_trigger()) {
+                fuse_data();
+            }
+        }
+        fuse_data(); // Drain whatever arrived before stop()
+        if (debug) std::printf("[DEBUG] Fusion thread stopped\n");
+    }
+
+    // Stop all threads
+    void stop() {
+        *running = false;
+        wake_fusion();
+        if (debug) std::printf("[DEBUG] Stopping all threads\n");
+    }
+
+    // Get current state (thread-safe)
+    StateEstimate get_state() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return state;
+    }
+
+    // Timestamped history of published states; lock-free to query from any thread
+    // (value_at(t), window(from, to)) while the fusion thread keeps appending.
+    const History& history() const { return history_ring; }
+
+    // State predicted to time t from the latest fused readings (thread-safe).
+    StateEstimate get_state_at(steady_clock::time_point t) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return engine.estimate_at(t);
+    }
+
+    // Filter state at its last applied reading: independent of wall-clock time, so two
+    // replays of the same log give bit-identical results.
+    StateEstimate get_filter_state() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return engine.estimate_at(engine.time());
+    }
+
+    // Distribution of sensor timestamp -> fused state latency over all fused readings.
+    perf_utils::LatencyHistogram latency_histogram() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return latency;
+    }
+
+    uint64_t fused_readings() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return engine.update_count();
+    }
+
+    uint64_t dropped_readings() {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        return dropped;
+    }
+
+    uint64_t unknown_readings() {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        return unknown;
+    }
+
+    std::size_t pending_readings() {
+        std::lock_guard<std::mutex> lock(readings_mutex);
+        return sensor_readings.size();
+    }
+
+    uint64_t late_readings() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return engine.late_count();
+    }
+};
+
+} // namespace fusion
+
+#endif // SENSOR_FUSION_H
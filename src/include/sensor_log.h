@@ -0,0 +1,153 @@
+#ifndef SENSOR_LOG_H
+#define SENSOR_LOG_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "fusion_engine.h"
+
+namespace fusion {
+
+// Compact binary log of SensorData streams for record/replay.
+//
+// File layout: 8-byte header "SFLOG\0\1\0" followed by records of
+//   zigzag varint  timestamp delta in ns from the previous record (may be negative:
+//                  sensor threads stamp readings before taking the buffer lock)
+//   varint         sensor_id
+//   8 bytes        value (IEEE-754 double, little-endian host order)
+// A typical record is 12-13 bytes. Timestamps are stored relative to the first record,
+// so a log can be replayed onto any clock origin.
+
+inline constexpr char SENSOR_LOG_MAGIC[8] = {'S', 'F', 'L', 'O', 'G', '\0', '\1', '\0'};
+
+// One reading as stored in the log: time since the first record.
+struct LoggedReading {
+    int64_t t_ns;
+    int sensor_id;
+    double value;
+};
+
+// Buffered log writer. Not thread-safe: SensorFusion calls it under its readings lock.
+class SensorLogWriter {
+public:
+    SensorLogWriter() = default;
+    SensorLogWriter(const SensorLogWriter&) = delete;
+    SensorLogWriter& operator=(const SensorLogWriter&) = delete;
+    ~SensorLogWriter() { close(); }
+
+    bool open(const char* path) {
+        close();
+        file = std::fopen(path, "wb");
+        if (!file) return false;
+        std::fwrite(SENSOR_LOG_MAGIC, 1, sizeof(SENSOR_LOG_MAGIC), file);
+        buffer.reserve(BUFFER_SIZE);
+        have_origin = false;
+        records = 0;
+        return true;
+    }
+
+    bool is_open() const { return file != nullptr; }
+
+    void write(const SensorData& data) {
+        if (!file) return;
+        if (!have_origin) {
+            origin = data.timestamp;
+            previous_ns = 0;
+            have_origin = true;
+        }
+        int64_t t_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(data.timestamp - origin).count();
+        int64_t delta = t_ns - previous_ns;
+        previous_ns = t_ns;
+        put_varint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        put_varint(static_cast<uint64_t>(data.sensor_id));
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &data.value, sizeof(double));
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(double));
+        ++records;
+        if (buffer.size() >= BUFFER_SIZE - 32) flush();
+    }
+
+    void flush() {
+        if (file && !buffer.empty()) {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+    }
+
+    void close() {
+        if (!file) return;
+        flush();
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    uint64_t record_count() const { return records; }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    std::FILE* file = nullptr;
+    std::vector<unsigned char> buffer;
+    steady_clock::time_point origin{};
+    int64_t previous_ns = 0;
+    bool have_origin = false;
+    uint64_t records = 0;
+
+    void put_varint(uint64_t v) {
+        while (v >= 0x80) {
+            buffer.push_back(static_cast<unsigned char>(v | 0x80));
+            v >>= 7;
+        }
+        buffer.push_back(static_cast<unsigned char>(v));
+    }
+};
+
+// Load a whole log. Records are returned in timestamp order (stable, so readings with
+// equal timestamps keep their recorded order). Returns false on a missing or corrupt file.
+inline bool read_sensor_log(const char* path, std::vector<LoggedReading>& out) {
+    out.clear();
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) return false;
+    std::vector<unsigned char> bytes;
+    unsigned char chunk[64 * 1024];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    std::fclose(file);
+
+    if (bytes.size() < sizeof(SENSOR_LOG_MAGIC) ||
+        std::memcmp(bytes.data(), SENSOR_LOG_MAGIC, sizeof(SENSOR_LOG_MAGIC)) != 0) {
+        return false;
+    }
+    std::size_t pos = sizeof(SENSOR_LOG_MAGIC);
+    auto get_varint = [&](uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && pos < bytes.size(); shift += 7) {
+            unsigned char b = bytes[pos++];
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    };
+
+    int64_t t_ns = 0;
+    while (pos < bytes.size()) {
+        uint64_t zz, id;
+        if (!get_varint(zz) || !get_varint(id) || pos + sizeof(double) > bytes.size()) return false;
+        t_ns += static_cast<int64_t>(zz >> 1) ^ -static_cast<int64_t>(zz & 1);
+        double value;
+        std::memcpy(&value, bytes.data() + pos, sizeof(double));
+        pos += sizeof(double);
+        out.push_back({t_ns, static_cast<int>(id), value});
+    }
+    std::stable_sort(out.begin(), out.end(), [](const LoggedReading& a, const LoggedReading& b) {
+        return a.t_ns < b.t_ns;
+    });
+    return true;
+}
+
+} // namespace fusion
+
+#endif // SENSOR_LOG_H
@@ -0,0 +1,313 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "cache_padded.h"
+#include "cpu_relax.h"
+
+namespace sync_utils {
+
+namespace detail {
+
+// Shared (not FUTEX_PRIVATE) futex: the word may be mapped at different addresses in
+// different processes; the kernel keys it by the underlying page.
+inline long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout = nullptr) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+
+[[noreturn]] inline void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace detail
+
+// A MAP_SHARED mapping of a memory file, for placing a ShmRing where several processes
+// can see it. Throws std::system_error if the file cannot be created, sized or mapped.
+//   anonymous()  memfd_create: no name in the filesystem. Children inherit the mapping
+//                across fork(); unrelated processes get fd() over a Unix socket
+//                (SCM_RIGHTS) and use from_fd().
+//   create()     shm_open(O_CREAT | O_EXCL) under /dev/shm; the name is unlinked when
+//                the creating ShmRegion is destroyed.
+//   open()       shm_open an existing name, e.g. from a sensor process.
+class ShmRegion {
+public:
+    static ShmRegion anonymous(const char* name, std::size_t size) {
+        int fd = memfd_create(name, MFD_CLOEXEC);
+        if (fd < 0) detail::throw_errno("memfd_create");
+        return ShmRegion(fd, size, true, {});
+    }
+
+    static ShmRegion create(const std::string& name, std::size_t size) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) detail::throw_errno("shm_open");
+        return ShmRegion(fd, size, true, name);
+    }
+
+    static ShmRegion open(const std::string& name, std::size_t size) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) detail::throw_errno("shm_open");
+        return ShmRegion(fd, size, false, {});
+    }
+
+    // Takes ownership of `fd`.
+    static ShmRegion from_fd(int fd, std::size_t size) { return ShmRegion(fd, size, false, {}); }
+
+    ShmRegion(ShmRegion&& other) noexcept
+        : file(std::exchange(other.file, -1)), base(std::exchange(other.base, nullptr)),
+          length(std::exchange(other.length, 0)), owned_name(std::move(other.owned_name)) {
+        other.owned_name.clear();
+    }
+
+    ShmRegion& operator=(ShmRegion&& other) noexcept {
+        if (this != &other) {
+            release();
+            file = std::exchange(other.file, -1);
+            base = std::exchange(other.base, nullptr);
+            length = std::exchange(other.length, 0);
+            owned_name = std::move(other.owned_name);
+            other.owned_name.clear();
+        }
+        return *this;
+    }
+
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+    ~ShmRegion() { release(); }
+
+    void* data() const { return base; }
+    std::size_t size() const { return length; }
+    int fd() const { return file; }
+
+private:
+    ShmRegion(int fd, std::size_t size, bool resize, std::string unlink_name)
+        : file(fd), length(size), owned_name(std::move(unlink_name)) {
+        if (resize && ftruncate(fd, static_cast<off_t>(size)) != 0) fail("ftruncate");
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            fail("mmap");
+        }
+    }
+
+    [[noreturn]] void fail(const char* what) {
+        int err = errno;
+        release();
+        errno = err;
+        detail::throw_errno(what);
+    }
+
+    void release() {
+        if (base) munmap(base, length);
+        if (file >= 0) close(file);
+        if (!owned_name.empty()) shm_unlink(owned_name.c_str());
+        base = nullptr;
+        file = -1;
+        owned_name.clear();
+    }
+
+    int file = -1;
+    void* base = nullptr;
+    std::size_t length = 0;
+    std::string owned_name;
+};
+
+struct ShmRingStats {
+    uint64_t dropped = 0; // try_push() calls that found the ring full
+    uint64_t wakes = 0;   // Producer futex wake-ups (only when the consumer was asleep)
+    uint64_t sleeps = 0;  // Consumer futex waits
+};
+
+// SpscRing for two processes: one producer process and one consumer process sharing a
+// ShmRegion. The ring is a single self-contained object (header, indices and slots)
+// placed at the start of the region with create() and found by the other process with
+// attach(). It holds no pointers, only 32-bit sequence numbers and inline slots, so each
+// process may map it at a different address.
+//
+// Zero copy: the producer writes a reading straight into its slot (claim() + publish())
+// and the consumer reads it in place (peek() / wait() + release()).
+//
+// No syscalls on the fast path: publishing is one release store, and the producer only
+// calls futex(FUTEX_WAKE) when the consumer has announced it is going to sleep in wait().
+// The consumer spins briefly before sleeping, on the `tail` index itself as the futex
+// word, so a publish between its check and its sleep makes FUTEX_WAIT return at once.
+// The producer never blocks: a full ring rejects the reading and counts it dropped.
+//
+// T must be trivially copyable (it is shared as bytes). One ring per producer: several
+// sensor processes publish to the fusion process through one ring each.
+template <typename T, std::size_t Capacity>
+class ShmRing {
+    static_assert(std::is_trivially_copyable_v<T>, "elements are shared between processes as bytes");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(Capacity <= (std::size_t{1} << 31), "indices are 32-bit");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                  "atomics in shared memory must be lock-free (address-free)");
+
+public:
+    // Bytes a ShmRegion needs to hold the ring.
+    static constexpr std::size_t bytes() { return sizeof(ShmRing); }
+
+    // Construct the ring at the start of `memory` (the creating process, once).
+    static ShmRing* create(void* memory) {
+        auto* ring = ::new (memory) ShmRing();
+        ring->magic.store(MAGIC, std::memory_order_release);
+        return ring;
+    }
+
+    // The ring another process created in `memory`; nullptr if it does not hold a
+    // ShmRing of this element size and capacity (or has not been created yet).
+    static ShmRing* attach(void* memory) {
+        auto* ring = std::launder(static_cast<ShmRing*>(memory));
+        if (ring->magic.load(std::memory_order_acquire) != MAGIC) return nullptr;
+        return ring->element_size == sizeof(T) && ring->capacity == Capacity ? ring : nullptr;
+    }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Producer: the next free slot to fill, or nullptr if the ring is full. The slot is
+    // not visible to the consumer until publish().
+    T* claim() {
+        uint32_t t = tail->load(std::memory_order_relaxed);
+        if (t - producer->head_cache >= Capacity) {
+            producer->head_cache = head->load(std::memory_order_acquire);
+            if (t - producer->head_cache >= Capacity) return nullptr;
+        }
+        return slot(t);
+    }
+
+    // Producer: make the claimed slot visible, waking the consumer if it is asleep.
+    void publish() {
+        tail->store(tail->load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+        if (consumer_waiting->load(std::memory_order_seq_cst)) {
+            producer->wakes.fetch_add(1, std::memory_order_relaxed);
+            detail::futex(*tail, FUTEX_WAKE, 1);
+        }
+    }
+
+    bool try_push(const T& value) {
+        T* s = claim();
+        if (!s) {
+            producer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        *s = value;
+        publish();
+        return true;
+    }
+
+    // Consumer: the oldest element, or nullptr if empty. Valid until release().
+    const T* peek() {
+        uint32_t h = head->load(std::memory_order_relaxed);
+        if (h == consumer->tail_cache) {
+            consumer->tail_cache = tail->load(std::memory_order_acquire);
+            if (h == consumer->tail_cache) return nullptr;
+        }
+        return slot(h);
+    }
+
+    // Consumer: as peek(), but wait for an element: spin `spins` times, then sleep on the
+    // futex. nullptr after `timeout` (e.g. to notice that the producer process died).
+    const T* wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max(), int spins = 128) {
+        for (int i = 0; i < spins; ++i) {
+            if (const T* p = peek()) return p;
+            cpu_relax();
+        }
+        const bool bounded = timeout != std::chrono::nanoseconds::max();
+        const auto deadline = std::chrono::steady_clock::now() + (bounded ? timeout : std::chrono::nanoseconds::zero());
+        const uint32_t h = head->load(std::memory_order_relaxed);
+        while (true) {
+            consumer_waiting->store(1, std::memory_order_seq_cst);
+            uint32_t t = tail->load(std::memory_order_seq_cst);
+            if (t == h) {
+                timespec ts{};
+                if (bounded) {
+                    auto left = deadline - std::chrono::steady_clock::now();
+                    if (left <= std::chrono::nanoseconds::zero()) {
+                        consumer_waiting->store(0, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+                    ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+                    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+                }
+                consumer->sleeps.fetch_add(1, std::memory_order_relaxed);
+                detail::futex(*tail, FUTEX_WAIT, h, bounded ? &ts : nullptr); // Returns at once if tail moved
+            }
+            consumer_waiting->store(0, std::memory_order_relaxed);
+            if (const T* p = peek()) return p;
+        }
+    }
+
+    // Consumer: drop the element returned by peek() / wait().
+    void release() { head->store(head->load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool try_pop(T& out) {
+        const T* p = peek();
+        if (!p) return false;
+        out = *p;
+        release();
+        return true;
+    }
+
+    // Approximate when called concurrently with either side.
+    std::size_t size() const {
+        return static_cast<uint32_t>(tail->load(std::memory_order_acquire) - head->load(std::memory_order_acquire));
+    }
+
+    ShmRingStats stats() const {
+        return {producer->dropped.load(std::memory_order_relaxed), producer->wakes.load(std::memory_order_relaxed),
+                consumer->sleeps.load(std::memory_order_relaxed)};
+    }
+
+    static constexpr std::size_t ring_capacity() { return Capacity; }
+
+private:
+    static constexpr uint64_t MAGIC = 0x53484d52494e4731; // "SHMRING1"
+    static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1);
+
+    // Role-private state, still in the shared object so every field is position-independent.
+    struct ProducerSide {
+        uint32_t head_cache = 0;
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> wakes{0};
+    };
+    struct ConsumerSide {
+        uint32_t tail_cache = 0;
+        std::atomic<uint64_t> sleeps{0};
+    };
+
+    ShmRing() = default;
+
+    T* slot(uint32_t i) { return std::launder(reinterpret_cast<T*>(&storage[(i & MASK) * sizeof(T)])); }
+
+    std::atomic<uint64_t> magic{0};
+    uint32_t element_size = sizeof(T);
+    uint32_t capacity = static_cast<uint32_t>(Capacity);
+    CachePadded<std::atomic<uint32_t>> head{0u};             // Next sequence to read (consumer-owned)
+    CachePadded<std::atomic<uint32_t>> consumer_waiting{0u}; // Consumer is (about to be) in FUTEX_WAIT
+    CachePadded<ConsumerSide> consumer;
+    CachePadded<std::atomic<uint32_t>> tail{0u}; // Next sequence to write (producer-owned); the futex word
+    CachePadded<ProducerSide> producer;
+    alignas(CACHE_LINE) alignas(T) unsigned char storage[Capacity * sizeof(T)];
+};
+
+} // namespace sync_utils
+
+#endif // SHM_RING_H
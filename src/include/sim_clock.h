@@ -0,0 +1,69 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace time_utils {
+
+// Clocks a scheduler can be instantiated with. Both hand out system_clock time points,
+// so formatTime() and friends work unchanged; they differ in what waiting means.
+//
+//   now()                               current time
+//   sleep_for(d)                        simulated execution / delay of d
+//   wait_until(cv, lock, t, pred)       block until pred() or t, like cv.wait_until
+//
+// Clock-agnostic code calls these on a clock object instead of std::chrono and
+// std::this_thread directly.
+
+// Wall-clock time; waiting really blocks.
+struct RealClock {
+    using time_point = std::chrono::system_clock::time_point;
+    using duration = std::chrono::system_clock::duration;
+    static constexpr bool is_virtual = false;
+
+    time_point now() const { return std::chrono::system_clock::now(); }
+
+    void sleep_for(duration d) const { std::this_thread::sleep_for(d); }
+
+    template <typename Pred>
+    bool wait_until(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, time_point t, Pred pred) const {
+        return cv.wait_until(lock, t, pred);
+    }
+};
+
+// Discrete-event time for simulation: time only moves when the (single) simulated thread
+// waits, and then jumps straight to the end of the wait. An hour of a periodic task set
+// costs only the scheduler's own bookkeeping per event. Not thread-safe: the simulation
+// must run on one thread, with nothing else expected to satisfy a wait's predicate.
+class VirtualClock {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+    using duration = std::chrono::system_clock::duration;
+    static constexpr bool is_virtual = true;
+
+    explicit VirtualClock(time_point start = time_point{}) : t(start) {}
+
+    time_point now() const { return t; }
+
+    void sleep_for(duration d) { t += d; }
+
+    void advance_to(time_point u) { t = std::max(t, u); }
+
+    template <typename Pred>
+    bool wait_until(std::condition_variable&, std::unique_lock<std::mutex>&, time_point u, Pred pred) {
+        if (pred()) return true;
+        advance_to(u);
+        return pred();
+    }
+
+private:
+    time_point t;
+};
+
+} // namespace time_utils
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,104 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "cache_padded.h"
+
+namespace sync_utils {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+//
+// head and tail are monotonically increasing 64-bit counters on their own cache lines;
+// each side also keeps a private copy of the other side's counter and only reloads it
+// when the ring looks full (producer) or empty (consumer), so in steady state a push or
+// pop touches no cache line owned by the other thread except the slot itself.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            while (front()) pop();
+        }
+    }
+
+    // Producer side. false if the ring is full.
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        uint64_t t = tail->load(std::memory_order_relaxed);
+        if (t - head_cache >= Capacity) {
+            head_cache = head->load(std::memory_order_acquire);
+            if (t - head_cache >= Capacity) return false;
+        }
+        ::new (static_cast<void*>(slot(t))) T(std::forward<Args>(args)...);
+        tail->store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // Consumer side. false if the ring is empty.
+    bool try_pop(T& out) {
+        uint64_t h = head->load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail->load(std::memory_order_acquire);
+            if (h == tail_cache) return false;
+        }
+        T* p = slot(h);
+        out = std::move(*p);
+        p->~T();
+        head->store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pointer to the oldest element, or nullptr if empty. Valid until pop().
+    T* front() {
+        uint64_t h = head->load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail->load(std::memory_order_acquire);
+            if (h == tail_cache) return nullptr;
+        }
+        return slot(h);
+    }
+
+    // Consumer side: drop the element returned by front().
+    void pop() {
+        uint64_t h = head->load(std::memory_order_relaxed);
+        slot(h)->~T();
+        head->store(h + 1, std::memory_order_release);
+    }
+
+    // Approximate when called concurrently with the other side.
+    std::size_t size() const {
+        return static_cast<std::size_t>(tail->load(std::memory_order_acquire) -
+                                        head->load(std::memory_order_acquire));
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr uint64_t MASK = Capacity - 1;
+
+    T* slot(uint64_t i) { return std::launder(reinterpret_cast<T*>(&storage[(i & MASK) * sizeof(T)])); }
+
+    CachePadded<std::atomic<uint64_t>> head{0u};  // Next index to pop (consumer-owned)
+    alignas(CACHE_LINE) uint64_t tail_cache = 0;  // Consumer's copy of tail
+    CachePadded<std::atomic<uint64_t>> tail{0u};  // Next index to push (producer-owned)
+    alignas(CACHE_LINE) uint64_t head_cache = 0;  // Producer's copy of head
+    alignas(CACHE_LINE) alignas(T) unsigned char storage[Capacity * sizeof(T)];
+};
+
+} // namespace sync_utils
+
+#endif // SPSC_RING_H
@@ -0,0 +1,183 @@
+#ifndef STATE_HISTORY_H
+#define STATE_HISTORY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include "fusion_engine.h"
+
+namespace fusion {
+
+// Aggregates over a time window of the fused state history.
+struct WindowStats {
+    std::size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double trend = 0.0; // Least-squares slope of fused_value, units per second
+};
+
+// Fixed-capacity ring of timestamped StateEstimates with one writer (the fusion thread)
+// and any number of lock-free readers.
+//
+// Every slot is a small seqlock whose sequence number also encodes which history index
+// it holds (2i+1 while entry i is being written, 2i+2 once published). A reader that
+// finds any other value knows the slot was overwritten by a lapping writer and retries
+// from a fresh snapshot of the head, so readers never block the writer and never see a
+// torn entry. Fields are relaxed atomics so the protocol is race-free under the C++
+// memory model (no memcpy of shared plain data).
+template <std::size_t Capacity>
+class StateHistory {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Writer side. Timestamps must be non-decreasing.
+    void append(const StateEstimate& e) {
+        uint64_t i = head.load(std::memory_order_relaxed);
+        Slot& s = slots[i & MASK];
+        s.seq.store(2 * i + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.t_ns.store(e.last_updated.time_since_epoch().count(), std::memory_order_relaxed);
+        s.value.store(e.fused_value, std::memory_order_relaxed);
+        s.velocity.store(e.velocity, std::memory_order_relaxed);
+        s.variance.store(e.variance, std::memory_order_relaxed);
+        s.seq.store(2 * i + 2, std::memory_order_release);
+        head.store(i + 1, std::memory_order_release);
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(std::min<uint64_t>(head.load(std::memory_order_acquire), Capacity - 1));
+    }
+
+    std::optional<StateEstimate> latest() const {
+        for (;;) {
+            uint64_t h = head.load(std::memory_order_acquire);
+            if (h == 0) return std::nullopt;
+            StateEstimate e;
+            if (read(h - 1, e)) return e;
+        }
+    }
+
+    // Fused value at time t, linearly interpolated between the bracketing entries.
+    // Past the newest entry the newest state is extrapolated with its velocity.
+    // nullopt if the history is empty or t is older than what is retained.
+    std::optional<StateEstimate> value_at(steady_clock::time_point t) const {
+        const int64_t tq = t.time_since_epoch().count();
+        for (;;) {
+            uint64_t h = head.load(std::memory_order_acquire);
+            if (h == 0) return std::nullopt;
+            uint64_t lo = oldest_index(h);
+            StateEstimate newest, oldest;
+            if (!read(h - 1, newest) || !read(lo, oldest)) continue;
+            if (tq >= stamp(newest)) {
+                double dt = std::chrono::duration<double>(t - newest.last_updated).count();
+                return StateEstimate{newest.fused_value + newest.velocity * dt, t, newest.velocity, newest.variance};
+            }
+            if (tq < stamp(oldest)) return std::nullopt;
+
+            // Binary search for the last entry with timestamp <= t in [lo, h-1).
+            uint64_t left = lo, right = h - 1;
+            StateEstimate a = oldest;
+            bool lapped = false;
+            while (right - left > 1) {
+                uint64_t mid = left + (right - left) / 2;
+                StateEstimate m;
+                if (!read(mid, m)) {
+                    lapped = true;
+                    break;
+                }
+                if (stamp(m) <= tq) {
+                    left = mid;
+                    a = m;
+                } else {
+                    right = mid;
+                }
+            }
+            StateEstimate b;
+            if (lapped || !read(left, a) || !read(left + 1, b)) continue;
+            int64_t span = stamp(b) - stamp(a);
+            double w = span > 0 ? static_cast<double>(tq - stamp(a)) / span : 1.0;
+            return StateEstimate{a.fused_value + w * (b.fused_value - a.fused_value), t,
+                                 a.velocity + w * (b.velocity - a.velocity),
+                                 a.variance + w * (b.variance - a.variance)};
+        }
+    }
+
+    // min/max/mean/trend of fused_value over entries stamped in [from, to]. Entries that
+    // the writer overwrites while the scan is in progress are simply no longer part of
+    // the retained window.
+    WindowStats window(steady_clock::time_point from, steady_clock::time_point to) const {
+        const int64_t t0 = from.time_since_epoch().count();
+        const int64_t t1 = to.time_since_epoch().count();
+        WindowStats st;
+        st.min = std::numeric_limits<double>::infinity();
+        st.max = -std::numeric_limits<double>::infinity();
+        double sum = 0.0, sum_t = 0.0, sum_tt = 0.0, sum_tv = 0.0;
+
+        uint64_t h = head.load(std::memory_order_acquire);
+        // Newest to oldest, stopping at the window start or at an overwritten slot.
+        for (uint64_t i = h; i > oldest_index(h); --i) {
+            StateEstimate e;
+            if (!read(i - 1, e)) break;
+            int64_t ts = stamp(e);
+            if (ts > t1) continue;
+            if (ts < t0) break;
+            double v = e.fused_value;
+            double x = static_cast<double>(ts - t1) * 1e-9; // Seconds relative to `to`
+            st.min = std::min(st.min, v);
+            st.max = std::max(st.max, v);
+            sum += v;
+            sum_t += x;
+            sum_tt += x * x;
+            sum_tv += x * v;
+            ++st.count;
+        }
+        if (st.count == 0) return WindowStats{};
+        double n = static_cast<double>(st.count);
+        st.mean = sum / n;
+        double denom = n * sum_tt - sum_t * sum_t;
+        st.trend = denom > 0.0 ? (n * sum_tv - sum_t * sum) / denom : 0.0;
+        return st;
+    }
+
+private:
+    static constexpr uint64_t MASK = Capacity - 1;
+
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<int64_t> t_ns{0};
+        std::atomic<double> value{0.0};
+        std::atomic<double> velocity{0.0};
+        std::atomic<double> variance{0.0};
+    };
+
+    std::atomic<uint64_t> head{0}; // Number of entries ever appended
+    Slot slots[Capacity];
+
+    // The slot for index h may already be being rewritten, so keep Capacity - 1 entries.
+    static uint64_t oldest_index(uint64_t h) { return h > Capacity - 1 ? h - (Capacity - 1) : 0; }
+
+    static int64_t stamp(const StateEstimate& e) { return e.last_updated.time_since_epoch().count(); }
+
+    bool read(uint64_t index, StateEstimate& out) const {
+        const Slot& s = slots[index & MASK];
+        uint64_t expected = 2 * index + 2;
+        if (s.seq.load(std::memory_order_acquire) != expected) return false;
+        int64_t t = s.t_ns.load(std::memory_order_relaxed);
+        out.fused_value = s.value.load(std::memory_order_relaxed);
+        out.velocity = s.velocity.load(std::memory_order_relaxed);
+        out.variance = s.variance.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != expected) return false;
+        out.last_updated = steady_clock::time_point(steady_clock::duration(t));
+        return true;
+    }
+};
+
+} // namespace fusion
+
+#endif // STATE_HISTORY_H
@@ -0,0 +1,114 @@
+// inplace_function_bench.cpp
+/*
+ Construction and call cost of callable wrappers (include/inplace_function.h).
+  Task::work in scheduler.cpp used to be a std::function wrapping another std::function;
+  carArrived() and Foo::first() took std::function by value on every call. Compared here:
+    direct          template parameter, the compiler sees the callable (lower bound)
+    std::function   type-erased, heap-allocates captures larger than 16 bytes (libstdc++)
+    InplaceFunction type-erased, fixed 64-byte inline buffer, never allocates
+    function_ref    non-owning pointer pair, for parameters that are only called
+  for lambdas capturing 8, 24 and 48 bytes. "construct+call" builds a wrapper per call
+  (the carArrived pattern), "call" reuses one wrapper (the Task::work pattern). Heap
+  allocations are counted with a global operator new.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include "./include/inplace_function.h"
+
+using func_utils::function_ref;
+using func_utils::InplaceFunction;
+
+static std::atomic<long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+template <typename T>
+inline void keep(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+constexpr long ITERATIONS = 20'000'000;
+
+// Call sites are noinline so each wrapper is really used through its interface.
+template <typename F>
+[[gnu::noinline]] long call_direct(F& f, long i) { return f(i); }
+[[gnu::noinline]] long call_std(const std::function<long(long)>& f, long i) { return f(i); }
+[[gnu::noinline]] long call_inplace(const InplaceFunction<long(long), 64>& f, long i) { return f(i); }
+[[gnu::noinline]] long call_ref(function_ref<long(long)> f, long i) { return f(i); }
+
+template <int Bytes>
+struct Capture {
+    long v[Bytes / sizeof(long)];
+};
+
+struct Result {
+    double ns;
+    double allocs;
+};
+
+template <typename Body>
+Result measure(Body&& body) {
+    long before = allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    long sink = 0;
+    for (long i = 0; i < ITERATIONS; ++i) sink += body(i);
+    auto t1 = std::chrono::steady_clock::now();
+    keep(sink);
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count() / ITERATIONS,
+            static_cast<double>(allocations.load() - before) / ITERATIONS};
+}
+
+template <int Bytes>
+void run() {
+    Capture<Bytes> c{};
+    for (auto& x : c.v) x = 1;
+    keep(c);
+    auto lambda = [c](long i) { return i + c.v[0] + c.v[sizeof(c.v) / sizeof(long) - 1]; };
+
+    Result direct_cc = measure([&](long i) {
+        auto f = lambda;
+        return call_direct(f, i);
+    });
+    Result std_cc = measure([&](long i) { return call_std(std::function<long(long)>(lambda), i); });
+    Result inplace_cc = measure([&](long i) { return call_inplace(InplaceFunction<long(long), 64>(lambda), i); });
+    Result ref_cc = measure([&](long i) { return call_ref(lambda, i); });
+
+    std::function<long(long)> sf(lambda);
+    InplaceFunction<long(long), 64> inf(lambda);
+    Result direct_c = measure([&](long i) { return call_direct(lambda, i); });
+    Result std_c = measure([&](long i) { return call_std(sf, i); });
+    Result inplace_c = measure([&](long i) { return call_inplace(inf, i); });
+    Result ref_c = measure([&](long i) { return call_ref(lambda, i); });
+
+    auto row = [](const char* name, Result cc, Result c) {
+        std::printf("  %-16s %10.2f %12.2f %10.2f\n", name, cc.ns, cc.allocs, c.ns);
+    };
+    std::printf("capture %d bytes        construct+call ns   allocs/op    call ns\n", Bytes);
+    row("direct", direct_cc, direct_c);
+    row("std::function", std_cc, std_c);
+    row("InplaceFunction", inplace_cc, inplace_c);
+    row("function_ref", ref_cc, ref_c);
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 inplace_function_bench.cpp -o inplace_function_bench\n");
+    std::printf("sizeof: std::function %zu, InplaceFunction<.., 64> %zu, function_ref %zu\n\n",
+                sizeof(std::function<long(long)>), sizeof(InplaceFunction<long(long), 64>),
+                sizeof(function_ref<long(long)>));
+    run<8>();
+    run<24>();
+    run<48>();
+    return 0;
+}
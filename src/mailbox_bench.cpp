@@ -0,0 +1,150 @@
+// mailbox_bench.cpp
+/*
+ Latest-value hand-off from a sensor thread to a controller thread.
+  The sample is value + timestamp, as in pid_controller_2.cpp. Three ways to share it:
+    mutex      - struct guarded by a std::mutex (pid_controller_1.cpp / pid_controller_2.cpp)
+    atomic x2  - one std::atomic per field (pid_controller_grok_2.cpp); each field is
+                 race-free but the pair can be read torn (value from one sample,
+                 timestamp from another)
+    Mailbox    - triple buffer from include/mailbox.h, wait-free on both sides
+  The writer publishes at a fixed rate (or as fast as it can) while the reader polls the
+  latest sample in a loop. Sample n carries value n and timestamp n * period, so a
+  reader can detect torn pairs exactly. Reported: writes/s, reads/s, ns per read, torn
+  reads, and how old the sample was when read (paced runs only).
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "./include/cpu_relax.h"
+#include "./include/mailbox.h"
+
+using namespace std::chrono_literals;
+using steady = std::chrono::steady_clock;
+
+struct Sample {
+    double value = 0.0;
+    int64_t t_ns = 0; // Intended sample time relative to the start of the run
+};
+
+class MutexBox {
+public:
+    void write(const Sample& s) {
+        std::lock_guard<std::mutex> lock(mtx);
+        sample = s;
+    }
+    Sample read() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return sample;
+    }
+
+private:
+    std::mutex mtx;
+    Sample sample;
+};
+
+class AtomicPairBox {
+public:
+    void write(const Sample& s) {
+        value.store(s.value, std::memory_order_release);
+        t_ns.store(s.t_ns, std::memory_order_release);
+    }
+    Sample read() {
+        return {value.load(std::memory_order_acquire), t_ns.load(std::memory_order_acquire)};
+    }
+
+private:
+    std::atomic<double> value{0.0};
+    std::atomic<int64_t> t_ns{0};
+};
+
+class MailboxBox {
+public:
+    void write(const Sample& s) { box.write(s); }
+    Sample read() { return box.read(); }
+
+private:
+    sync_utils::Mailbox<Sample> box;
+};
+
+struct Result {
+    double writes_per_s;
+    double reads_per_s;
+    double ns_per_read;
+    uint64_t torn;
+    double mean_age_us;
+};
+
+// rate_hz == 0: writer runs unpaced (period 1ns for the consistency check only).
+template <typename Box>
+Result run(double rate_hz, std::chrono::duration<double> duration) {
+    Box box;
+    const int64_t period_ns = rate_hz > 0 ? static_cast<int64_t>(1e9 / rate_hz) : 1;
+    std::atomic<bool> running{true};
+    uint64_t writes = 0;
+    auto start = steady::now();
+
+    std::thread writer([&]() {
+        for (uint64_t n = 1; running.load(std::memory_order_relaxed); ++n) {
+            int64_t due = static_cast<int64_t>(n) * period_ns;
+            if (rate_hz > 0) {
+                while ((steady::now() - start).count() < due) {
+                    if (!running.load(std::memory_order_relaxed)) return;
+                    sync_utils::cpu_relax();
+                }
+            }
+            box.write({static_cast<double>(n), due});
+            writes = n;
+        }
+    });
+
+    uint64_t reads = 0, torn = 0, aged = 0;
+    double age_sum = 0.0;
+    auto until = start + std::chrono::duration_cast<steady::duration>(duration);
+    steady::time_point now;
+    do {
+        for (int i = 0; i < 256; ++i) {
+            Sample s = box.read();
+            ++reads;
+            if (s.t_ns != static_cast<int64_t>(s.value) * period_ns) ++torn;
+        }
+        now = steady::now();
+        if (rate_hz > 0) {
+            Sample s = box.read();
+            if (s.t_ns > 0) {
+                age_sum += static_cast<double>((now - start).count() - s.t_ns);
+                ++aged;
+            }
+        }
+    } while (now < until);
+    running = false;
+    writer.join();
+
+    double secs = std::chrono::duration<double>(steady::now() - start).count();
+    return {writes / secs, reads / secs, secs * 1e9 / reads, torn, aged ? age_sum / aged / 1e3 : 0.0};
+}
+
+template <typename Box>
+void report(const char* label, double rate_hz) {
+    Result r = run<Box>(rate_hz, 500ms);
+    std::printf("%-10s %10.0f %14.0f %14.0f %10.1f %12llu", label, rate_hz, r.writes_per_s, r.reads_per_s,
+                r.ns_per_read, static_cast<unsigned long long>(r.torn));
+    if (rate_hz > 0) std::printf(" %12.2f\n", r.mean_age_us);
+    else std::printf(" %12s\n", "-");
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread mailbox_bench.cpp -o mailbox_bench\n");
+    std::printf("%-10s %10s %14s %14s %10s %12s %12s\n", "variant", "rate Hz", "writes/s", "reads/s",
+                "ns/read", "torn reads", "age us");
+    for (double rate : {10'000.0, 100'000.0, 1'000'000.0, 0.0}) {
+        report<MutexBox>("mutex", rate);
+        report<AtomicPairBox>("atomic x2", rate);
+        report<MailboxBox>("Mailbox", rate);
+    }
+    std::printf("(rate 0 = writer unpaced)\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+// ordered_sequencer_bench.cpp
+/*
+ Ordered execution hand-off latency: OrderedSequencer<N> vs. mutex + condition_variable.
+  Foo (print_first.cpp) and FooBar (foo_bar_print.cpp) run stages in order with one mutex,
+  one condition variable and notify_all(), so every step wakes every waiting stage and all
+  but one go straight back to sleep. OrderedSequencer gives each stage its own
+  std::atomic::wait slot so a step wakes exactly one thread.
+
+  Each configuration runs N threads, one per stage, for ITERATIONS hand-offs in total and
+  reports nanoseconds per hand-off. A small Foo demo shows the sequencer driving the
+  original first/second/third problem.
+*/
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include "./include/ordered_sequencer.h"
+
+using sync_utils::OrderedSequencer;
+
+// The Foo/FooBar approach generalised to N stages, kept as the baseline.
+template <std::size_t N>
+class CvSequencer {
+public:
+    template <typename F>
+    void run(std::size_t stage, F&& f) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return step % N == stage; });
+        f();
+        ++step;
+        cv.notify_all();
+    }
+
+private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::size_t step = 0;
+};
+
+template <typename Sequencer, std::size_t N>
+double handoff_ns(std::size_t iterations) {
+    Sequencer seq;
+    std::size_t rounds = iterations / N;
+    volatile std::size_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t stage = 0; stage < N; ++stage) {
+        threads.emplace_back([&, stage]() {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                seq.run(stage, [&]() { sink = sink + 1; });
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (sink != rounds * N) std::printf("ERROR: lost steps (%zu of %zu)\n", static_cast<std::size_t>(sink), rounds * N);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (rounds * N);
+}
+
+template <std::size_t N>
+void compare(std::size_t iterations) {
+    double cv_ns = handoff_ns<CvSequencer<N>, N>(iterations);
+    double seq_ns = handoff_ns<OrderedSequencer<N>, N>(iterations);
+    std::printf("stages=%zu  cv+notify_all: %8.1f ns/handoff   OrderedSequencer: %8.1f ns/handoff   speedup: %.2fx\n",
+                N, cv_ns, seq_ns, cv_ns / seq_ns);
+}
+
+// print_first.cpp's Foo expressed with the sequencer.
+class Foo {
+public:
+    template <typename F> void first(F printFirst) { seq.run(0, printFirst); }
+    template <typename F> void second(F printSecond) { seq.run(1, printSecond); }
+    template <typename F> void third(F printThird) { seq.run(2, printThird); }
+
+private:
+    OrderedSequencer<3> seq;
+};
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread ordered_sequencer_bench.cpp -o ordered_sequencer_bench\n");
+
+    Foo foo;
+    std::thread c([&]() { foo.third([]() { std::printf("third"); }); });
+    std::thread b([&]() { foo.second([]() { std::printf("second"); }); });
+    std::thread a([&]() { foo.first([]() { std::printf("first"); }); });
+    a.join();
+    b.join();
+    c.join();
+    std::printf("\n");
+
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    std::printf("Hand-off latency over %zu steps (hardware threads: %u)\n",
+                ITERATIONS, std::thread::hardware_concurrency());
+    compare<2>(ITERATIONS);
+    compare<3>(ITERATIONS);
+    compare<4>(ITERATIONS);
+    compare<8>(ITERATIONS);
+    return 0;
+}
@@ -0,0 +1,118 @@
+// overflow_policy_bench.cpp
+/*
+ Producer jitter behind a slow consumer for each BoundedBuffer overflow policy
+ (include/bounded_buffer.h).
+  A sensor-style producer samples every 1ms (sleeping to absolute release times) and
+  emplaces a timestamped reading into an 8-slot buffer. The consumer needs 1.5ms per
+  reading, so the buffer is full most of the time. A sample that starts more than one
+  period late counts as missed and the producer resynchronises to the next release, the
+  way a sensor that lost its slot would.
+  Reported per policy:
+    emplace p50/p99/max   time spent in emplace() (blocking shows up here)
+    late p99/max          how far behind its release each sample started
+    missed                periods skipped because the producer was stalled
+    delivered / lost      readings popped vs dropped, timed out or overwritten
+    age p50/p99           sample-to-pop latency seen by the consumer (staleness)
+
+ Usage: ./overflow_policy_bench [seconds_per_policy] [consumer_us_per_item]
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "./include/bounded_buffer.h"
+#include "./include/latency_histogram.h"
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+using perf_utils::LatencyHistogram;
+using sync_utils::OverflowPolicy;
+
+constexpr auto PERIOD = 1ms;
+constexpr std::size_t CAPACITY = 8;
+
+struct Reading {
+    uint64_t seq;
+    Clock::time_point sampled;
+    double value;
+};
+
+struct Result {
+    LatencyHistogram emplace_ns;
+    LatencyHistogram late_ns;
+    LatencyHistogram age_ns;
+    uint64_t samples = 0;
+    uint64_t missed = 0;
+    uint64_t delivered = 0;
+    sync_utils::OverflowStats stats;
+};
+
+Result run(OverflowPolicy policy, double seconds, std::chrono::microseconds consumer_cost) {
+    Result r;
+    sync_utils::BoundedBuffer<Reading, CAPACITY> buffer(policy);
+
+    std::thread consumer([&]() {
+        while (auto reading = buffer.pop()) {
+            r.age_ns.record(Clock::now() - reading->sampled);
+            ++r.delivered;
+            std::this_thread::sleep_for(consumer_cost); // Slow sink: logging, network, fusion
+        }
+    });
+
+    auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    auto release = Clock::now() + PERIOD;
+    for (uint64_t seq = 0; release < end; ++seq) {
+        std::this_thread::sleep_until(release);
+        auto start = Clock::now();
+        if (start - release > PERIOD) { // Stalled past the next release: skip to the one after now
+            auto skipped = (start - release) / PERIOD;
+            r.missed += static_cast<uint64_t>(skipped);
+            release += skipped * PERIOD;
+        }
+        r.late_ns.record(start - release);
+        buffer.emplace(Reading{seq, start, static_cast<double>(seq) * 0.001});
+        r.emplace_ns.record(Clock::now() - start);
+        ++r.samples;
+        release += PERIOD;
+    }
+    buffer.close();
+    consumer.join();
+    r.stats = buffer.stats();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread overflow_policy_bench.cpp -o overflow_policy_bench\n\n");
+    double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    auto consumer_cost = std::chrono::microseconds(argc > 2 ? std::atoi(argv[2]) : 1500);
+
+    struct Config {
+        const char* label;
+        OverflowPolicy policy;
+    };
+    const Config configs[] = {
+        {"block", OverflowPolicy::block()},
+        {"block_for(200us)", OverflowPolicy::block_for(200us)},
+        {"drop_newest", OverflowPolicy::drop_newest()},
+        {"drop_oldest", OverflowPolicy::drop_oldest()},
+        {"overwrite_latest", OverflowPolicy::overwrite_latest()},
+    };
+
+    std::printf("1ms producer, consumer %lldus/item, capacity %zu, %.1fs per policy (times in us, age in ms)\n",
+                static_cast<long long>(consumer_cost.count()), CAPACITY, seconds);
+    std::printf("%-18s %8s %8s %8s %9s %8s %9s %7s %9s %8s %8s %8s\n", "policy", "samples", "emp p50", "emp p99",
+                "emp max", "late p99", "late max", "missed", "delivered", "lost", "age p50", "age p99");
+    for (const auto& c : configs) {
+        Result r = run(c.policy, seconds, consumer_cost);
+        uint64_t lost = r.stats.dropped_newest + r.stats.timed_out + r.stats.closed_waiting + r.stats.dropped_oldest +
+                        r.stats.overwritten;
+        std::printf("%-18s %8llu %8.1f %8.1f %9.1f %8.1f %9.1f %7llu %9llu %8llu %8.2f %8.2f\n", c.label,
+                    static_cast<unsigned long long>(r.samples), r.emplace_ns.percentile(50) / 1e3,
+                    r.emplace_ns.percentile(99) / 1e3, r.emplace_ns.max() / 1e3, r.late_ns.percentile(99) / 1e3,
+                    r.late_ns.max() / 1e3, static_cast<unsigned long long>(r.missed),
+                    static_cast<unsigned long long>(r.delivered), static_cast<unsigned long long>(lost),
+                    r.age_ns.percentile(50) / 1e6, r.age_ns.percentile(99) / 1e6);
+    }
+    return 0;
+}
@@ -1,9 +1,42 @@
 // pid_bench_cpp20.cpp
+/*
+ Sensor -> controller hand-off benchmark matrix (Google Benchmark).
+  BM_CPP20_PID_Multithread is the original measurement: one mutex, and two threads
+  created and joined inside every timed iteration, so thread start-up dominates.
+  BM_Handoff<H> measures only the hand-off. The sensor thread is started once per run
+  and publishes {seq, value} as fast as it can. The controller (the benchmark thread)
+  reads the latest sample and runs the PID once per iteration. Primitives:
+    Mutex        std::mutex around the sample
+    Spinlock     test-and-test-and-set on an atomic<bool>, cpu_relax while held
+    Seqlock      sequence counter + relaxed atomic fields, reader retries on overlap
+    AtomicDouble one std::atomic<double> (value only, seq is derived from it)
+    TripleBuffer sync_utils::Mailbox (include/mailbox.h)
+    Spsc         sync_utils::SpscRing (include/spsc_ring.h), reader drains to the newest
+  Arg pin: 0 = unpinned, 1 = sensor and controller on different CPUs, 2 = same CPU.
+  Counters:
+    updates/s         sensor publishes per second while the controller was timed
+    seq_gap           mean sequence distance between consecutive reads (staleness:
+                      updates the controller never saw, +1)
+    repeat_reads      share of reads that returned the same sample as the previous one
+    torn              reads whose value does not belong to their seq (must be 0)
+    dropped           publishes rejected by a full ring (Spsc only)
+    cache_miss/read   controller-thread cache misses per read, via perf_event_open;
+    cache_miss/update sensor-thread cache misses per publish; omitted when the PMU is
+                      not accessible
+*/
 #include <benchmark/benchmark.h>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <cmath>
+#include <memory>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include "./include/cpu_relax.h"
+#include "./include/mailbox.h"
+#include "./include/perf_counters.h"
+#include "./include/spsc_ring.h"
 
 struct SharedData {
     std::mutex mtx;
@@ -59,6 +92,239 @@ static void BM_CPP20_PID_Multithread(benchmark::State& state) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Hand-off primitives: publish() from the sensor thread, read() from the controller.
+
+struct Sample {
+    uint64_t seq = 0;
+    double value = 0.0;
+};
+
+inline double value_of(uint64_t seq) { return static_cast<double>(seq) * 0.001; }
+
+class MutexHandoff {
+public:
+    bool publish(const Sample& s) {
+        std::lock_guard<std::mutex> lock(mtx);
+        sample = s;
+        return true;
+    }
+    Sample read() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return sample;
+    }
+
+private:
+    std::mutex mtx;
+    Sample sample;
+};
+
+class SpinlockHandoff {
+public:
+    bool publish(const Sample& s) {
+        lock();
+        sample = s;
+        locked.store(false, std::memory_order_release);
+        return true;
+    }
+    Sample read() {
+        lock();
+        Sample s = sample;
+        locked.store(false, std::memory_order_release);
+        return s;
+    }
+
+private:
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed)) sync_utils::cpu_relax();
+        }
+    }
+
+    std::atomic<bool> locked{false};
+    Sample sample;
+};
+
+class SeqlockHandoff {
+public:
+    bool publish(const Sample& s) {
+        uint64_t v = version.load(std::memory_order_relaxed);
+        version.store(v + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        seq.store(s.seq, std::memory_order_relaxed);
+        value.store(s.value, std::memory_order_relaxed);
+        version.store(v + 2, std::memory_order_release);
+        return true;
+    }
+    Sample read() {
+        for (;;) {
+            uint64_t v1 = version.load(std::memory_order_acquire);
+            if (v1 & 1) {
+                sync_utils::cpu_relax();
+                continue;
+            }
+            Sample s{seq.load(std::memory_order_relaxed), value.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == v1) return s;
+        }
+    }
+
+private:
+    std::atomic<uint64_t> version{0};
+    std::atomic<uint64_t> seq{0};
+    std::atomic<double> value{0.0};
+};
+
+class AtomicDoubleHandoff {
+public:
+    bool publish(const Sample& s) {
+        value.store(s.value, std::memory_order_release);
+        return true;
+    }
+    Sample read() {
+        double v = value.load(std::memory_order_acquire);
+        return {static_cast<uint64_t>(std::llround(v * 1000.0)), v};
+    }
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+class TripleBufferHandoff {
+public:
+    bool publish(const Sample& s) {
+        box.write(s);
+        return true;
+    }
+    Sample read() { return box.read(); }
+
+private:
+    sync_utils::Mailbox<Sample> box;
+};
+
+class SpscHandoff {
+public:
+    bool publish(const Sample& s) { return ring.try_push(s); }
+    Sample read() {
+        while (ring.try_pop(newest)) {}
+        return newest;
+    }
+
+private:
+    sync_utils::SpscRing<Sample, 1024> ring;
+    Sample newest; // Consumer-owned
+};
+
+// ---------------------------------------------------------------------------
+
+enum Pinning { UNPINNED = 0, SEPARATE_CPUS = 1, SAME_CPU = 2 };
+
+static std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+static bool pin_to(pthread_t thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+template <typename Handoff>
+static void BM_Handoff(benchmark::State& state) {
+    const auto pinning = static_cast<Pinning>(state.range(0));
+    const std::vector<int> cpus = allowed_cpus();
+    if (pinning == SEPARATE_CPUS && cpus.size() < 2) {
+        state.SkipWithError("needs two CPUs");
+        return;
+    }
+
+    auto handoff = std::make_unique<Handoff>();
+    std::atomic<bool> running{true};
+    std::atomic<bool> started{false};
+    std::atomic<uint64_t> published{0}; // Refreshed every 256 publishes to keep it off the hot path
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> sensor_misses{0};
+    std::atomic<bool> sensor_pmu{false};
+
+    std::thread sensor([&]() {
+        perf_utils::PerfCounter misses = perf_utils::PerfCounter::cache_misses();
+        misses.start();
+        uint64_t seq = 0, drops = 0;
+        started.store(true, std::memory_order_release);
+        while (running.load(std::memory_order_relaxed)) {
+            ++seq;
+            if (!handoff->publish({seq, value_of(seq)})) ++drops;
+            if ((seq & 255) == 0) published.store(seq, std::memory_order_relaxed);
+        }
+        misses.stop();
+        published.store(seq, std::memory_order_relaxed);
+        dropped.store(drops, std::memory_order_relaxed);
+        sensor_misses.store(misses.read(), std::memory_order_relaxed);
+        sensor_pmu.store(misses.valid(), std::memory_order_relaxed);
+    });
+
+    cpu_set_t original;
+    pthread_getaffinity_np(pthread_self(), sizeof(original), &original);
+    if (pinning == SEPARATE_CPUS) {
+        pin_to(sensor.native_handle(), cpus[1]);
+        pin_to(pthread_self(), cpus[0]);
+    } else if (pinning == SAME_CPU) {
+        pin_to(sensor.native_handle(), cpus[0]);
+        pin_to(pthread_self(), cpus[0]);
+    }
+    while (!started.load(std::memory_order_acquire)) std::this_thread::yield();
+
+    PID pid(1.0, 0.1, 0.05);
+    perf_utils::PerfCounter misses = perf_utils::PerfCounter::cache_misses();
+    uint64_t last = 0, gap_sum = 0, repeats = 0, torn = 0;
+    uint64_t published_before = published.load(std::memory_order_relaxed);
+    misses.start();
+    for (auto _ : state) {
+        Sample s = handoff->read();
+        torn += s.value != value_of(s.seq);
+        repeats += s.seq == last;
+        gap_sum += s.seq - last;
+        last = s.seq;
+        benchmark::DoNotOptimize(pid.compute(5.0, s.value));
+    }
+    misses.stop();
+    uint64_t published_during = published.load(std::memory_order_relaxed) - published_before;
+
+    running.store(false, std::memory_order_relaxed);
+    sensor.join();
+    pthread_setaffinity_np(pthread_self(), sizeof(original), &original);
+
+    const double reads = static_cast<double>(state.iterations());
+    state.counters["updates/s"] = benchmark::Counter(static_cast<double>(published_during), benchmark::Counter::kIsRate);
+    state.counters["seq_gap"] = static_cast<double>(gap_sum) / reads;
+    state.counters["repeat_reads"] = static_cast<double>(repeats) / reads;
+    state.counters["torn"] = static_cast<double>(torn);
+    if (dropped.load()) state.counters["dropped"] = static_cast<double>(dropped.load());
+    if (misses.valid()) state.counters["cache_miss/read"] = static_cast<double>(misses.read()) / reads;
+    if (sensor_pmu.load() && published.load())
+        state.counters["cache_miss/update"] = static_cast<double>(sensor_misses.load()) / published.load();
+}
+
 BENCHMARK(BM_CPP20_PID_Multithread)->Arg(1000000);
+
+#define HANDOFF_BENCHMARK(H) \
+    BENCHMARK_TEMPLATE(BM_Handoff, H)->ArgName("pin")->Arg(UNPINNED)->Arg(SEPARATE_CPUS)->Arg(SAME_CPU)->UseRealTime()
+
+HANDOFF_BENCHMARK(MutexHandoff);
+HANDOFF_BENCHMARK(SpinlockHandoff);
+HANDOFF_BENCHMARK(SeqlockHandoff);
+HANDOFF_BENCHMARK(AtomicDoubleHandoff);
+HANDOFF_BENCHMARK(TripleBufferHandoff);
+HANDOFF_BENCHMARK(SpscHandoff);
+
 BENCHMARK_MAIN();
 //g++ -std=c++20 -O2 -pthread pid_bnechmark_chatgpt.cpp -lbenchmark -o cpp_bench
+// ./cpp_bench --benchmark_filter=BM_Handoff --benchmark_counters_tabular=true
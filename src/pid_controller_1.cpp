@@ -6,6 +6,7 @@
 #include <sstream>
 #include <cstdio>
 #include <string>
+#include "./include/perf_counters.h"
 
 std::atomic<bool> running(true);
 
@@ -74,7 +75,10 @@ void controller_thread(SharedData& shared, PID& pid) {
             local_sensor_value = shared.sensor_value;
         }
         error = setpoint - local_sensor_value;
-        output = pid.compute(error);
+        {
+            perf_utils::PerfScope scope("PID::compute");
+            output = pid.compute(error);
+        }
         {
             std::lock_guard<std::mutex> lock(shared.mtx);
             shared.plant_state += output * dt;
@@ -99,5 +103,6 @@ int main() {
     sensor.join();
     controller.join();
 
+    perf_utils::perf_report();
     return 0;
 } // 473 lines of asm
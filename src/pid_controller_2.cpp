@@ -6,6 +6,9 @@
 #include <sstream>
 #include <string>
 #include <cstdio>
+#include <stop_token>
+#include "./include/atomic_plant.h"
+#include "./include/rt_thread.h"
 
 using namespace std::chrono_literals;
 
@@ -40,13 +43,12 @@ std::string get_thread_id_str() {
     return ss.str();
 }
 
-void sensorThread(SharedSensorData& data, bool& running) {
+void sensorThread(std::stop_token st, SharedSensorData& data) {
     std::string thread_id = get_thread_id_str();
     std::mt19937 rng(std::random_device{}());
     std::uniform_real_distribution<double> dist(0.0, 10.0);
 
-    while (running) {
-        std::this_thread::sleep_for(2s);  // Simulate slow sensor
+    while (control::sleep_for(st, 2s)) {  // Simulate slow sensor; wakes early on stop
 
         double simulated_value = dist(rng);
         {
@@ -60,12 +62,11 @@ void sensorThread(SharedSensorData& data, bool& running) {
     }
 }
 
-void controlThread(SharedSensorData& data, bool& running, double setpoint) {
+void controlThread(std::stop_token st, SharedSensorData& data, double setpoint) {
     std::string thread_id = get_thread_id_str();
     PIDController pid(1.0, 0.1, 0.05);
 
-    while (running) {
-        std::this_thread::sleep_for(500ms);
+    while (control::sleep_for(st, 500ms)) {
 
         double current_value;
         {
@@ -86,15 +87,27 @@ int main() {
 
     SharedSensorData sensorData;
     sensorData.timestamp = std::chrono::steady_clock::now();
-    bool running = true;
     double setpoint = 5.0;
 
-    std::thread sensor(sensorThread, std::ref(sensorData), std::ref(running));
-    std::thread controller(controlThread, std::ref(sensorData), std::ref(running), setpoint);
+    // A plain bool shared by reference is a data race: the compiler may read it once and
+    // spin forever. jthread owns a stop_source and passes each thread its stop_token.
+    // The controller gets SCHED_FIFO, memory locking and a prefaulted stack when the
+    // process may have them; otherwise it runs as a normal thread and says so on stderr.
+    rt_utils::ThreadConfig sensor_cfg;
+    sensor_cfg.name = "sensor";
+    rt_utils::ThreadConfig control_cfg;
+    control_cfg.name = "controller";
+    control_cfg.policy = rt_utils::Policy::Fifo;
+    control_cfg.priority = 80;
+    control_cfg.lock_memory = true;
+    control_cfg.prefault_stack = 64 * 1024;
+    std::jthread sensor = rt_utils::make_jthread(sensor_cfg, sensorThread, std::ref(sensorData));
+    std::jthread controller = rt_utils::make_jthread(control_cfg, controlThread, std::ref(sensorData), setpoint);
 
     std::this_thread::sleep_for(10s);
 
-    running = false;
+    sensor.request_stop();
+    controller.request_stop();
     sensor.join();
     controller.join();
 
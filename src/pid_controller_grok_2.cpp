@@ -5,12 +5,16 @@
 #include <sstream>
 #include <cstdio>
 #include <string>
+#include "./include/atomic_plant.h"
+#include "./include/cache_padded.h"
 
 std::atomic<bool> running(true);
 
+// The controller writes plant_state and the sensor writes sensor_value; on one cache line
+// every write by either thread would invalidate the other's copy (false sharing).
 struct SharedData {
-    std::atomic<double> plant_state{1.0};  // Actual system state
-    std::atomic<double> sensor_value{1.0}; // Delayed sensor reading
+    sync_utils::CachePadded<control::AtomicPlant> plant_state{1.0}; // Actual system state, updated by read-modify-write only
+    sync_utils::CachePadded<std::atomic<double>> sensor_value{1.0}; // Delayed sensor reading
 };
 
 class PID {
@@ -37,10 +41,10 @@ void sensor_thread(SharedData& shared) {
     oss << std::this_thread::get_id();
     std::string thread_id = oss.str();
     while (running.load(std::memory_order_relaxed)) {
-        double local_plant_state = shared.plant_state.load(std::memory_order_acquire);
+        double local_plant_state = shared.plant_state->load();
         std::this_thread::sleep_for(std::chrono::milliseconds(500)); // Simulate sensor delay
         if (!running.load(std::memory_order_relaxed)) break;
-        shared.sensor_value.store(local_plant_state, std::memory_order_release);
+        shared.sensor_value->store(local_plant_state, std::memory_order_release);
         std::printf("Sensor thread %s: Updated sensor_value to %f\n", 
                     thread_id.c_str(), local_plant_state);
     }
@@ -54,12 +58,11 @@ void controller_thread(SharedData& shared, PID& pid) {
     const double dt = 0.01; // 10ms control loop
 
     while (running.load(std::memory_order_relaxed)) {
-        double local_sensor_value = shared.sensor_value.load(std::memory_order_acquire);
+        double local_sensor_value = shared.sensor_value->load(std::memory_order_acquire);
         double error = setpoint - local_sensor_value;
         double output = pid.compute(error);
-        double old_plant_state = shared.plant_state.load(std::memory_order_acquire);
-        double new_plant_state = old_plant_state + output * dt;
-        shared.plant_state.store(new_plant_state, std::memory_order_release);
+        // One fetch_add: a separate load and store would lose any update made in between.
+        double new_plant_state = shared.plant_state->add(output * dt);
         std::printf("Controller thread %s: sensor_value = %f, output = %f, plant_state = %f\n",
                     thread_id.c_str(), local_sensor_value, output, new_plant_state);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -72,7 +75,7 @@ int main() {
     PID pid(1.0, 0.1, 0.01, 0.01); // Kp=1.0, Ki=0.1, Kd=0.01
 
     // Check if std::atomic<double> is lock-free
-    if (!shared.plant_state.is_lock_free() || !shared.sensor_value.is_lock_free()) {
+    if (!shared.plant_state->is_lock_free() || !shared.sensor_value->is_lock_free()) {
         std::printf("Error: std::atomic<double> is not lock-free on this platform\n");
         return 1;
     }
@@ -0,0 +1,184 @@
+// pid_plant_sim.cpp
+/*
+ Closed-loop PID evaluation against a simulated plant (include/plant_sim.h).
+  The PID programs so far move the plant with `plant_state += output * dt`, which has no
+  dynamics to control. Here the plant is a first- or second-order system with the 500ms
+  sensor delay of pid_controller_1.cpp as transport dead time and Gaussian sensor noise,
+  controlled at 100Hz (the 10ms loop of pid_controller_1.cpp).
+
+  Offline mode: one thread steps physics and controller in lock-step as fast as possible.
+    Deterministic (bit-identical across runs) and far faster than real time, so gains can
+    be swept quickly. Reports step-response quality and the cost of one control tick.
+  Threaded mode: a plant thread advances physics in real time and publishes samples
+    through a Mailbox, a controller thread runs on its own period and writes the actuator
+    through an atomic. Reports the same step metrics plus the sample age at actuation and
+    the time from wake-up to actuator write (loop-execution latency).
+
+ Usage: ./pid_plant_sim [threaded_seconds]
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "./include/latency_histogram.h"
+#include "./include/mailbox.h"
+#include "./include/plant_sim.h"
+
+using namespace control;
+using namespace std::chrono_literals;
+using perf_utils::LatencyHistogram;
+using steady = std::chrono::steady_clock;
+
+struct Gains {
+    double kp, ki, kd;
+};
+
+struct Scenario {
+    const char* name;
+    PlantConfig plant;
+    Gains gains;
+};
+
+constexpr double SETPOINT = 1.0;
+constexpr double CONTROL_PERIOD = 0.01; // 100Hz
+constexpr double U_LIMIT = 10.0;
+
+void print_metrics(const StepMetrics& m) {
+    std::printf("rise %6.3fs  overshoot %6.2f%%  settling(2%%) ", m.rise_time, m.overshoot_pct);
+    if (std::isnan(m.settling_time)) std::printf("%8s", "never");
+    else std::printf("%7.3fs", m.settling_time);
+    std::printf("  ss error %+.4f\n", m.steady_state_error);
+}
+
+struct OfflineResult {
+    std::vector<double> trace;
+    double wall_seconds;
+};
+
+// Physics and controller in lock-step on the calling thread.
+OfflineResult run_offline(const Scenario& sc, double sim_seconds, LatencyHistogram* tick_hist) {
+    PlantSim plant(sc.plant);
+    PidController pid(sc.gains.kp, sc.gains.ki, sc.gains.kd, CONTROL_PERIOD, -U_LIMIT, U_LIMIT);
+    const auto steps = static_cast<uint64_t>(std::lround(sim_seconds / sc.plant.dt));
+    const auto steps_per_tick = static_cast<uint64_t>(std::lround(CONTROL_PERIOD / sc.plant.dt));
+
+    OfflineResult r;
+    r.trace.reserve(steps);
+    double u = 0.0;
+    auto start = steady::now();
+    for (uint64_t i = 0; i < steps; ++i) {
+        if (i % steps_per_tick == 0) {
+            auto t0 = steady::now();
+            u = pid.compute(SETPOINT, plant.measure());
+            if (tick_hist) tick_hist->record(steady::now() - t0);
+        }
+        plant.step(u);
+        r.trace.push_back(plant.output());
+    }
+    r.wall_seconds = std::chrono::duration<double>(steady::now() - start).count();
+    return r;
+}
+
+struct Sample {
+    double value = 0.0;
+    steady::time_point taken{};
+    uint64_t seq = 0;
+};
+
+// Plant thread in real time, controller thread on its own period.
+void run_threaded(const Scenario& sc, double seconds) {
+    sync_utils::Mailbox<Sample> sensor;
+    std::atomic<double> actuator{0.0};
+    std::vector<double> trace;
+    LatencyHistogram age_hist, loop_hist;
+    uint64_t ticks = 0, stale_ticks = 0;
+
+    const auto steps = static_cast<uint64_t>(std::lround(seconds / sc.plant.dt));
+    const auto dt = std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(sc.plant.dt));
+    const auto period = std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(CONTROL_PERIOD));
+    trace.reserve(steps);
+    auto start = steady::now() + 10ms;
+
+    {
+        std::jthread controller([&](std::stop_token st) {
+            PidController pid(sc.gains.kp, sc.gains.ki, sc.gains.kd, CONTROL_PERIOD, -U_LIMIT, U_LIMIT);
+            uint64_t last_seq = 0;
+            for (auto due = start; !st.stop_requested(); due += period) {
+                std::this_thread::sleep_until(due);
+                auto woke = steady::now();
+                bool fresh = sensor.update();
+                const Sample& s = sensor.front_buffer();
+                actuator.store(pid.compute(SETPOINT, s.value), std::memory_order_release);
+                auto done = steady::now();
+                if (!fresh || s.seq == last_seq) ++stale_ticks;
+                last_seq = s.seq;
+                if (s.seq) age_hist.record(done - s.taken);
+                loop_hist.record(done - woke);
+                ++ticks;
+            }
+        });
+
+        PlantSim plant(sc.plant);
+        for (uint64_t i = 0; i < steps; ++i) {
+            std::this_thread::sleep_until(start + dt * static_cast<int64_t>(i));
+            plant.step(actuator.load(std::memory_order_acquire));
+            trace.push_back(plant.output());
+            sensor.write({plant.measure(), steady::now(), i + 1});
+        }
+    }
+
+    std::printf("  threaded %5.1fs  ", seconds);
+    print_metrics(analyze_step(trace, SETPOINT, sc.plant.dt));
+    std::printf("    %llu controller ticks, %llu without a new sample\n", static_cast<unsigned long long>(ticks),
+                static_cast<unsigned long long>(stale_ticks));
+    age_hist.print("    sample age at actuation");
+    loop_hist.print("    wake-up -> actuator write");
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread pid_plant_sim.cpp -o pid_plant_sim\n");
+    double threaded_seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    constexpr double SIM_SECONDS = 30.0;
+
+    PlantConfig first;
+    first.order = PlantConfig::FirstOrder;
+    first.time_constant = 1.0;
+
+    PlantConfig second;
+    second.order = PlantConfig::SecondOrder;
+    second.natural_freq = 2.0;
+    second.damping = 0.3;
+
+    auto delayed = [](PlantConfig c) {
+        c.dead_time = 0.5; // Sensor delay of pid_controller_1.cpp
+        c.noise_stddev = 0.01;
+        return c;
+    };
+
+    const Scenario scenarios[] = {
+        {"1st order, tau 1s", first, {2.0, 2.0, 0.0}},
+        {"1st order, tau 1s, 500ms dead time, noise", delayed(first), {0.6, 0.8, 0.0}},
+        {"2nd order, wn 2, zeta 0.3", second, {1.0, 1.0, 0.3}},
+        {"2nd order, wn 2, zeta 0.3, 500ms dead time, noise", delayed(second), {0.3, 0.5, 0.1}},
+    };
+
+    for (const auto& sc : scenarios) {
+        std::printf("\n%s  (PID %.2f/%.2f/%.2f, 100Hz)\n", sc.name, sc.gains.kp, sc.gains.ki, sc.gains.kd);
+        LatencyHistogram tick_hist;
+        auto a = run_offline(sc, SIM_SECONDS, &tick_hist);
+        auto b = run_offline(sc, SIM_SECONDS, nullptr);
+        std::printf("  offline  %5.1fs  ", SIM_SECONDS);
+        print_metrics(analyze_step(a.trace, SETPOINT, sc.plant.dt));
+        std::printf("    %.1fms wall (%.0fx real time), deterministic: %s\n", a.wall_seconds * 1e3,
+                    SIM_SECONDS / a.wall_seconds, a.trace == b.trace ? "yes" : "NO");
+        tick_hist.print("    control tick");
+        run_threaded(sc, threaded_seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+// pid_plant_stress.cpp
+/*
+ Concurrent updates of a shared plant state: correctness and cost.
+  In pid_controller_grok_2.cpp the controller did load -> compute -> store on the plant
+  state. Each step is atomic, the sequence is not: as soon as a second thread also moves
+  the plant (a disturbance, the plant dynamics) updates made between the load and the
+  store are silently lost. ThreadSanitizer does not report this, since every access is
+  atomic; the state is simply wrong.
+
+  Part 1 hammers one plant from several threads with known increments and compares the
+  final state with the exact sum for four update strategies:
+    load+store  - the original pattern
+    mutex       - lock around the read-modify-write
+    CAS loop    - AtomicPlant::update (compare_exchange_weak)
+    fetch_add   - AtomicPlant::add (C++20 atomic<double>::fetch_add)
+  Part 2 runs a PID controller at 100kHz against the plant while a disturbance thread
+  kicks it at 100kHz, both as std::jthreads stopped through their stop_token, and checks
+  that every applied delta is accounted for.
+
+  Build with -fsanitize=thread to confirm the program is data-race free.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <numbers>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "./include/atomic_plant.h"
+#include "./include/cpu_relax.h"
+
+using namespace std::chrono_literals;
+using steady = std::chrono::steady_clock;
+
+class LoadStorePlant {
+public:
+    double load() const { return x.load(std::memory_order_acquire); }
+    void apply(double d) {
+        double old = x.load(std::memory_order_acquire);
+        x.store(old + d, std::memory_order_release);
+    }
+
+private:
+    std::atomic<double> x{0.0};
+};
+
+class MutexPlant {
+public:
+    double load() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return x;
+    }
+    void apply(double d) {
+        std::lock_guard<std::mutex> lock(mtx);
+        x += d;
+    }
+
+private:
+    mutable std::mutex mtx;
+    double x = 0.0;
+};
+
+class CasPlant {
+public:
+    double load() const { return plant.load(); }
+    void apply(double d) {
+        plant.update([d](double x) { return x + d; });
+    }
+
+private:
+    control::AtomicPlant plant;
+};
+
+class FetchAddPlant {
+public:
+    double load() const { return plant.load(); }
+    void apply(double d) { plant.add(d); }
+
+private:
+    control::AtomicPlant plant;
+};
+
+// Part 1: `threads` writers each add 1.0 `per_thread` times. Integers are exact in a
+// double, so any shortfall is lost updates.
+template <typename Plant>
+void hammer(const char* label, int threads, int per_thread) {
+    Plant plant;
+    auto start = steady::now();
+    {
+        std::vector<std::jthread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&plant, per_thread]() {
+                for (int i = 0; i < per_thread; ++i) plant.apply(1.0);
+            });
+        }
+    }
+    double secs = std::chrono::duration<double>(steady::now() - start).count();
+    double expected = static_cast<double>(threads) * per_thread;
+    double lost = expected - plant.load();
+    std::printf("%-12s %12.1f %14.0f %10.4f%%\n", label, secs * 1e9 / expected, lost, 100.0 * lost / expected);
+}
+
+// Spin until `due`; returns false if stop was requested meanwhile.
+bool wait_until(std::stop_token& st, steady::time_point due) {
+    while (steady::now() < due) {
+        if (st.stop_requested()) return false;
+        sync_utils::cpu_relax();
+    }
+    return !st.stop_requested();
+}
+
+struct LoopStats {
+    uint64_t ticks = 0;
+    uint64_t overruns = 0; // Ticks started more than one period late
+    double applied = 0.0;  // Sum of every delta this thread applied
+};
+
+// Part 2: PID at `rate_hz` holding the plant at a setpoint under a periodic disturbance.
+template <typename Plant>
+void closed_loop(const char* label, double rate_hz, std::chrono::duration<double> duration) {
+    Plant plant;
+    const auto period = std::chrono::duration_cast<steady::duration>(std::chrono::duration<double>(1.0 / rate_hz));
+    const double dt = 1.0 / rate_hz;
+    const double setpoint = 1.0;
+    LoopStats ctl, dist;
+
+    auto start = steady::now();
+    {
+        std::jthread controller([&](std::stop_token st) {
+            double integral = 0.0, prev_error = 0.0;
+            auto due = start;
+            while (wait_until(st, due)) {
+                if (steady::now() - due > period) ++ctl.overruns;
+                double error = setpoint - plant.load();
+                integral += error * dt;
+                double u = 200.0 * error + 2000.0 * integral + 0.01 * (error - prev_error) / dt;
+                prev_error = error;
+                plant.apply(u * dt);
+                ctl.applied += u * dt;
+                ++ctl.ticks;
+                due += period;
+            }
+        });
+        std::jthread disturbance([&](std::stop_token st) {
+            auto due = start;
+            while (wait_until(st, due)) {
+                if (steady::now() - due > period) ++dist.overruns;
+                double kick = 0.5 * std::sin(2.0 * std::numbers::pi * 50.0 * dist.ticks * dt) * dt * 100.0;
+                plant.apply(kick);
+                dist.applied += kick;
+                ++dist.ticks;
+                due += period;
+            }
+        });
+        std::this_thread::sleep_for(duration);
+        // jthread destructors request stop and join.
+    }
+
+    double secs = std::chrono::duration<double>(steady::now() - start).count();
+    double accounted = ctl.applied + dist.applied;
+    std::printf("%-12s %12.0f %12.0f %10llu %10llu %14.3e %12.4f\n", label, ctl.ticks / secs, dist.ticks / secs,
+                static_cast<unsigned long long>(ctl.overruns), static_cast<unsigned long long>(dist.overruns),
+                std::fabs(plant.load() - accounted), setpoint - plant.load());
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread pid_plant_stress.cpp -o pid_plant_stress\n");
+    std::printf("  (TSan: g++ -std=c++20 -O1 -g -fsanitize=thread -pthread pid_plant_stress.cpp)\n");
+    double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    int threads = static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+    constexpr int PER_THREAD = 1'000'000;
+
+    control::AtomicPlant probe;
+    std::printf("atomic<double> lock-free: %s\n\n", probe.is_lock_free() ? "yes" : "no");
+
+    std::printf("Part 1: %d threads x %d increments of 1.0\n", threads, PER_THREAD);
+    std::printf("%-12s %12s %14s %11s\n", "strategy", "ns/update", "lost updates", "lost");
+    hammer<LoadStorePlant>("load+store", threads, PER_THREAD);
+    hammer<MutexPlant>("mutex", threads, PER_THREAD);
+    hammer<CasPlant>("CAS loop", threads, PER_THREAD);
+    hammer<FetchAddPlant>("fetch_add", threads, PER_THREAD);
+
+    std::printf("\nPart 2: PID at 100kHz + disturbance at 100kHz for %.1fs\n", seconds);
+    std::printf("%-12s %12s %12s %10s %10s %14s %12s\n", "strategy", "ctl Hz", "dist Hz", "ctl late", "dist late",
+                "unaccounted", "final error");
+    auto d = std::chrono::duration<double>(seconds);
+    closed_loop<LoadStorePlant>("load+store", 100'000.0, d);
+    closed_loop<MutexPlant>("mutex", 100'000.0, d);
+    closed_loop<CasPlant>("CAS loop", 100'000.0, d);
+    closed_loop<FetchAddPlant>("fetch_add", 100'000.0, d);
+    return 0;
+}
@@ -0,0 +1,141 @@
+// pipeline_bench.cpp
+/*
+ The sensing-to-actuation chain as one lock-free pipeline (include/pipeline.h):
+
+            +-> gps (position) -+
+   plant ---+                   +--> fusion (EKF) --> control (PID) --+--> actuator
+            +-> odometer (vel) -+                                     +--> logger
+
+  "plant" is a periodic source that steps a second-order PlantSim with the last command
+  the actuator wrote and emits the true state; the two sensor stages add noise (fan-out),
+  the fusion stage merges both streams in timestamp order into a FusionEngine (fan-in),
+  control runs a PidController on the fused position, and its command goes to both the
+  actuator and a logger (fan-out). Every edge is an SpscRing; nothing takes a lock.
+  Runs:
+    pool             every stage on one shared worker thread
+    own threads      every stage on its own thread, pinned round-robin to the allowed CPUs
+    slow logger      pool, with the logger spending `logger_us` per command: its input
+                     edge fills, back-pressure reaches the plant, which drops samples, and
+                     the report marks the logger as the busiest stage
+  Each run prints per-stage throughput, busy time, service time and input depth, then
+  end-to-end latency (plant sample -> actuator / logger), and the final plant output.
+
+ Usage: ./pipeline_bench [rate_hz] [seconds_per_run] [logger_us]
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+#include "./include/fusion_engine.h"
+#include "./include/pipeline.h"
+#include "./include/plant_sim.h"
+
+using namespace std::chrono_literals;
+using pipeline::Clock;
+using pipeline::Placement;
+
+struct Truth {
+    double position;
+    double velocity;
+    Clock::time_point sampled;
+};
+
+struct Command {
+    double u;
+};
+
+void run(const char* label, double rate, double seconds, bool own_threads, Clock::duration logger_cost) {
+    const double dt = 1.0 / rate;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(dt));
+    const double setpoint = 1.0;
+
+    control::PlantConfig plant_cfg;
+    plant_cfg.order = control::PlantConfig::SecondOrder;
+    plant_cfg.natural_freq = 4.0;
+    plant_cfg.damping = 0.7;
+    plant_cfg.dt = dt;
+    control::PlantSim plant(plant_cfg);
+    control::PidController pid(2.0, 1.0, 0.1, dt, -10.0, 10.0);
+    fusion::FusionEngine<2> engine({{"gps", fusion::MeasurementKind::Position, 0.05},
+                                    {"odometer", fusion::MeasurementKind::Velocity, 0.05}},
+                                   1.0);
+    std::atomic<double> command{0.0};
+    double previous = 0.0;
+    std::mt19937 gps_rng(1), odo_rng(2);
+    std::normal_distribution<double> gps_noise(0.0, 0.05), odo_noise(0.0, 0.05);
+    double logged = 0.0;
+
+    const auto cpus = rt_utils::allowed_cpus();
+    int next_cpu = 0;
+    auto where = [&]() {
+        if (!own_threads) return Placement::pool();
+        return Placement::pinned(cpus.empty() ? -1 : cpus[next_cpu++ % cpus.size()]);
+    };
+
+    pipeline::Pipeline<> p;
+    auto& source = p.source<Truth>("plant", period, [&]() -> std::optional<Truth> {
+        plant.step(command.load(std::memory_order_relaxed));
+        double y = plant.output();
+        Truth t{y, (y - previous) / dt, Clock::now()};
+        previous = y;
+        return t;
+    }, where());
+    auto& gps = p.stage<Truth, fusion::SensorData>("gps", [&](const Truth& t) -> std::optional<fusion::SensorData> {
+        return fusion::SensorData{t.position + gps_noise(gps_rng), t.sampled, 0};
+    }, where());
+    auto& odometer = p.stage<Truth, fusion::SensorData>("odometer", [&](const Truth& t) -> std::optional<fusion::SensorData> {
+        return fusion::SensorData{t.velocity + odo_noise(odo_rng), t.sampled, 1};
+    }, where());
+    auto& fuse = p.stage<fusion::SensorData, fusion::StateEstimate>(
+        "fusion", [&](const fusion::SensorData& r) -> std::optional<fusion::StateEstimate> {
+            if (!engine.apply(r)) return std::nullopt;
+            return engine.estimate_at(r.timestamp);
+        }, where());
+    auto& ctl = p.stage<fusion::StateEstimate, Command>("control", [&](const fusion::StateEstimate& e) -> std::optional<Command> {
+        return Command{pid.compute(setpoint, e.fused_value)};
+    }, where());
+    auto& actuator = p.sink<Command>("actuator", [&](const Command& c) {
+        command.store(c.u, std::memory_order_relaxed);
+    }, where());
+    auto& logger = p.sink<Command>("logger", [&](const Command& c) {
+        if (logger_cost.count() > 0) rt_utils::spin_for(logger_cost); // Serialising, I/O formatting
+        logged += c.u;
+    }, where());
+
+    p.connect(source, gps);
+    p.connect(source, odometer);
+    p.connect(gps, fuse);
+    p.connect(odometer, fuse);
+    p.connect(fuse, ctl);
+    p.connect(ctl, actuator);
+    p.connect(ctl, logger);
+
+    p.start(1);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    p.stop();
+
+    std::printf("\n%s\n", label);
+    p.report();
+    std::printf("plant output %.3f (setpoint %.1f), fusion applied %llu, late %llu\n", plant.output(), setpoint,
+                static_cast<unsigned long long>(engine.update_count()), static_cast<unsigned long long>(engine.late_count()));
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread pipeline_bench.cpp -o pipeline_bench\n\n");
+    double rate = argc > 1 ? std::atof(argv[1]) : 10000.0;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    auto logger_us = std::chrono::microseconds(argc > 3 ? std::atoi(argv[3]) : 150);
+    std::printf("plant at %.0f Hz, %.1fs per run, %zu CPU(s)\n", rate, seconds, rt_utils::allowed_cpus().size());
+
+    run("pool (1 worker)", rate, seconds, false, Clock::duration::zero());
+    run("own threads (pinned)", rate, seconds, true, Clock::duration::zero());
+    char label[64];
+    std::snprintf(label, sizeof(label), "pool, slow logger (%lldus per command)", static_cast<long long>(logger_us.count()));
+    run(label, rate, seconds, false, logger_us);
+    return 0;
+}
@@ -36,6 +36,7 @@ Explanation: The input [1,3,2] means thread A calls first(), thread B calls thir
 #include <vector>
 #include <algorithm>
 #include <random>
+#include "./include/inplace_function.h"
 
 class Foo {
 private:
@@ -46,14 +47,15 @@ private:
 public:
     Foo() : step(0) {}
 
-    void first(std::function<void()> printFirst) {
+    // The print callbacks are only called, never stored: take them by reference.
+    void first(func_utils::function_ref<void()> printFirst) {
         std::unique_lock<std::mutex> lock(mtx);
         printFirst();
         step = 1;
         cv.notify_all();
     }
 
-    void second(std::function<void()> printSecond) {
+    void second(func_utils::function_ref<void()> printSecond) {
         std::unique_lock<std::mutex> lock(mtx);
         cv.wait(lock, [this]() { return step >= 1; });
         printSecond();
@@ -61,7 +63,7 @@ public:
         cv.notify_all();
     }
 
-    void third(std::function<void()> printThird) {
+    void third(func_utils::function_ref<void()> printThird) {
         std::unique_lock<std::mutex> lock(mtx);
         cv.wait(lock, [this]() { return step >= 2; });
         printThird();
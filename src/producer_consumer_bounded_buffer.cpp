@@ -1,53 +1,51 @@
 // Producer-Consumer Bounded Buffer:
-#include <deque>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
-#include <atomic>
 #include <sstream>
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include "./include/bounded_buffer.h"
+#include "./include/perf_counters.h"
 
 // Shared Globals 
 constexpr size_t BUFFER_SIZE = 10;
 constexpr int MAX_ITEMS = 50;
-std::atomic<bool> running(true);
 
 /* 
-* std::deque (double-ended queue) is an indexed sequence container that allows fast 
-* insertion and deletion at both its beginning and its end.
-* In addition, insertion and deletion at either end of a deque never invalidates pointers 
-* or references to the rest of the elements. 
+* The buffer used to be a std::deque<int> under a mutex and two condition variables.
+* sync_utils::BoundedBuffer is the same protocol over a fixed ring of BUFFER_SIZE slots
+* for any element type: items are constructed in place and moved out, nothing is
+* allocated per item, and close() replaces the shared `running` flag.
+*
+* The consumer is slower than the producer (140ms vs 100ms), so the buffer fills up.
+* With the default policy the producer then waits for space and falls off its 100ms
+* period; pass an overflow policy to keep the producer on time and count what is lost:
+*   ./app [block | timeout | drop-newest | drop-oldest | overwrite]
 */
 
-struct SharedBuffer {
-	std::mutex mtx;
-	std::deque<int> buffer;
-	std::condition_variable not_empty;
-	std::condition_variable not_full;
-	
-};
+using SharedBuffer = sync_utils::BoundedBuffer<int, BUFFER_SIZE>;
 
-void producer(SharedBuffer& shared, int& prod_count) {
+void producer(SharedBuffer& shared) {
 	std::ostringstream oss;
 	oss << std::this_thread::get_id();
-	auto th_id = oss.str().c_str();
+	std::string th_id = oss.str(); // Owned copy: oss.str() is a temporary
 	int item = 1;
 	
 	while(item <= MAX_ITEMS) {
-		std::unique_lock<std::mutex> lock(shared.mtx);
-		shared.not_full.wait(lock, [&](){ return shared.buffer.size() < BUFFER_SIZE || ! running; });
-		if (!running && item > MAX_ITEMS) break;
-		
-		shared.buffer.push_back(item);
-		std::printf("Prod thread %s: item: %d, buf_size: %zu\n", th_id, item, shared.buffer.size());
-		++item;
-		++prod_count;
-		
-		lock.unlock();
-		shared.not_empty.notify_one();
+		{
+			perf_utils::PerfScope scope("buffer push"); // Includes waiting for space
+			if (shared.emplace(item)) {
+				std::printf("Prod thread %s: item: %d, buf_size: %zu\n", th_id.c_str(), item, shared.size());
+			} else if (shared.is_closed()) {
+				break;
+			} else {
+				std::printf("Prod thread %s: item: %d dropped (buffer full)\n", th_id.c_str(), item);
+			}
+			++item;
+		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 	}
+	shared.close(); // No more items: the consumer drains the rest and stops
 
 	return;
 }
@@ -55,19 +53,17 @@ void producer(SharedBuffer& shared, int& prod_count) {
 void consumer(SharedBuffer& shared, int& cons_count) {
 	std::ostringstream oss;
 	oss << std::this_thread::get_id();
-	auto th_id = oss.str().c_str();
+	std::string th_id = oss.str();
 	
-	while(cons_count < MAX_ITEMS) {
-		std::unique_lock<std::mutex> lock(shared.mtx);
-		shared.not_empty.wait(lock, [&]() {return !shared.buffer.empty() || !running;});
-		if (!running && shared.buffer.empty())
-			break;
-		auto item = shared.buffer.front();
-		shared.buffer.pop_front();
-		std::printf("Cons thread %s: item: %d, buf_size: %zu\n", th_id, item, shared.buffer.size());
-		++cons_count;
-		lock.unlock();
-		shared.not_full.notify_one();
+	while(true) {
+		{
+			perf_utils::PerfScope scope("buffer pop"); // Includes waiting for an item
+			auto item = shared.pop();
+			if (!item) // Closed and drained
+				break;
+			std::printf("Cons thread %s: item: %d, buf_size: %zu\n", th_id.c_str(), *item, shared.size());
+			++cons_count;
+		}
 		std::this_thread::sleep_for(std::chrono::milliseconds(140));
 	}
 	
@@ -75,30 +71,33 @@ void consumer(SharedBuffer& shared, int& cons_count) {
 }
 
 
-int main() {
+sync_utils::OverflowPolicy parse_policy(const char* name) {
+    if (std::strcmp(name, "timeout") == 0) return sync_utils::OverflowPolicy::block_for(std::chrono::milliseconds(50));
+    if (std::strcmp(name, "drop-newest") == 0) return sync_utils::OverflowPolicy::drop_newest();
+    if (std::strcmp(name, "drop-oldest") == 0) return sync_utils::OverflowPolicy::drop_oldest();
+    if (std::strcmp(name, "overwrite") == 0) return sync_utils::OverflowPolicy::overwrite_latest();
+    return sync_utils::OverflowPolicy::block();
+}
+
+int main(int argc, char** argv) {
 	std::printf("Compile: g++ -std=c++23 -pthread <file_name.CPP> -o <app_name>\n");
-    SharedBuffer shared;
-    int produced_count = 0;
+    SharedBuffer shared(parse_policy(argc > 1 ? argv[1] : "block"));
     int consumed_count = 0;
 
-    std::thread prod(producer, std::ref(shared), std::ref(produced_count));
+    std::thread prod(producer, std::ref(shared));
     std::thread cons(consumer, std::ref(shared), std::ref(consumed_count));
 
-    while (produced_count < MAX_ITEMS || consumed_count < MAX_ITEMS) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        {
-            std::lock_guard<std::mutex> lock(shared.mtx);
-            produced_count = shared.buffer.size() + consumed_count;
-        }
-    }
-    running = false;
-    shared.not_empty.notify_one();
-    shared.not_full.notify_one();
-
     prod.join();
     cons.join();
 
-    std::printf("Final: Produced %d items, Consumed %d items\n", produced_count, consumed_count);
+    auto stats = shared.stats();
+    // An overwrite replaces a queued item instead of adding one, so it produced nothing new.
+    auto produced_count = stats.accepted - stats.overwritten;
+    std::printf("Final: Produced %llu items, Consumed %d items\n", static_cast<unsigned long long>(produced_count), consumed_count);
+    std::printf("Overflow: %llu dropped (new), %llu timed out, %llu dropped (oldest), %llu overwritten\n",
+                static_cast<unsigned long long>(stats.dropped_newest), static_cast<unsigned long long>(stats.timed_out),
+                static_cast<unsigned long long>(stats.dropped_oldest), static_cast<unsigned long long>(stats.overwritten));
+    perf_utils::perf_report();
 
     return 0;
 } // 
@@ -106,10 +105,7 @@ int main() {
 /*
 
 #include <vector>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
-#include <atomic>
 #include <sstream>
 #include <cstdio>
 #include <string>
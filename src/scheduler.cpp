@@ -3,9 +3,20 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <deque>
 #include <vector>
 #include <functional>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <string>
+#include <cstdlib>
+#include <cstring>
+#include "./include/inplace_function.h"
+#include "./include/perf_counters.h"
+#include "./include/rt_thread.h"
+#include "./include/sim_clock.h"
 #include "./include/time_formatter.h"
 #include <stdio.h>
 
@@ -15,119 +26,207 @@ struct Task {
     int priority; // Higher value = higher priority
     std::chrono::milliseconds period;
     std::chrono::milliseconds execution_time;
-    std::chrono::system_clock::time_point next_deadline;
-    std::function<void()> work;
+    std::chrono::system_clock::time_point next_deadline; // Next release (the current job's deadline)
+    // Called with the task id at dispatch, so nothing captures `this`. Stored inline: no
+    // heap allocation per task.
+    func_utils::InplaceFunction<void(int)> work;
 
-    Task(int _id, int _priority, int period_ms, int exec_time_ms, std::function<void(int)> _work)
+    Task(int _id, int _priority, int period_ms, int exec_time_ms, std::chrono::system_clock::time_point first_release,
+         func_utils::InplaceFunction<void(int)> _work)
         : id(_id), priority(_priority), period(std::chrono::milliseconds(period_ms)),
-          execution_time(std::chrono::milliseconds(exec_time_ms)), next_deadline(std::chrono::system_clock::now()),
-          work([_id, this, _work]() { _work(id); })
+          execution_time(std::chrono::milliseconds(exec_time_ms)), next_deadline(first_release),
+          work(std::move(_work))
     {
-        std::printf("Created task %d: Priority=%d, Period=%ldms, ExecTime=%ldms at %s\n",
-                    id, priority, period.count(), execution_time.count(),
-                    time_utils::formatTime(std::chrono::system_clock::now()).c_str());
     }
 };
 
+// One released instance of a task. Its deadline is fixed at release: the task's own
+// next_deadline moves on while the job waits, and a heap key must not change. `task`
+// stays valid while addTask() grows the task list (a std::deque never moves its elements).
+struct Job {
+    Task* task;
+    std::chrono::system_clock::time_point deadline;
+};
+
 // Comparator for priority queue (Earliest Deadline First)
-struct TaskComparator {
-    bool operator()(const Task* t1, const Task* t2) const {
-        if (t1->next_deadline == t2->next_deadline)
-            return t1->priority < t2->priority; // Same deadline, higher priority first
-        return t1->next_deadline > t2->next_deadline; // Earlier deadline first
+struct JobComparator {
+    bool operator()(const Job& j1, const Job& j2) const {
+        if (j1.deadline == j2.deadline)
+            return j1.task->priority < j2.task->priority; // Same deadline, higher priority first
+        return j1.deadline > j2.deadline; // Earlier deadline first
+    }
+};
+
+struct SchedulerStats {
+    uint64_t jobs = 0;
+    uint64_t misses = 0;
+    std::chrono::system_clock::duration busy{};         // Sum of execution times
+    std::chrono::system_clock::duration elapsed{};      // start() -> stop(), or the simulated span
+    std::chrono::system_clock::duration max_lateness{}; // Worst completion past deadline
+
+    double utilization() const {
+        return elapsed.count() > 0 ? static_cast<double>(busy.count()) / elapsed.count() : 0.0;
     }
 };
 
+// Clock is time_utils::RealClock (a scheduler thread, real sleeps) or
+// time_utils::VirtualClock (simulate(): the same loop on the calling thread, where every
+// wait and every task's execution time just advances virtual time).
+template <typename Clock = time_utils::RealClock>
 class Scheduler {
 private:
-    std::vector<Task> tasks;
-    std::priority_queue<Task*, std::vector<Task*>, TaskComparator> ready_queue;
+    using time_point = typename Clock::time_point;
+
+    Clock clock;
+    bool trace; // Print every event (and profile the loop, on the real clock)
+    std::deque<Task> tasks; // Not a vector: queued and running jobs point into it
+    std::priority_queue<Job, std::vector<Job>, JobComparator> ready_queue;
     std::mutex mtx;
     std::condition_variable cv;
     bool running;
     std::thread scheduler_thread;
+    time_point started{};
+    time_point end_of_run = time_point::max();
+    SchedulerStats totals;
 
     void schedulerLoop() {
         while (true) {
-            std::unique_lock<std::mutex> lock(mtx);
-            if (!running) break;
-
-            auto now = std::chrono::system_clock::now();
-            // Check for tasks ready to run
-            for (auto& task : tasks) {
-                if (task.next_deadline <= now) {
-                    std::printf("Task %d ready at %s\n", task.id, time_utils::formatTime(now).c_str());
-                    ready_queue.push(&task);
-                    task.next_deadline += task.period; // Schedule next instance
-                }
+            if constexpr (Clock::is_virtual) {
+                if (!step()) break;
+            } else if (trace) {
+                perf_utils::PerfScope iteration("Scheduler::schedulerLoop");
+                if (!step()) break;
+            } else if (!step()) {
+                break;
             }
+        }
+    }
 
-            // Execute highest-priority task
-            if (!ready_queue.empty()) {
-                Task* task = ready_queue.top();
-                ready_queue.pop();
-                lock.unlock();
-
-                auto start_time = std::chrono::system_clock::now();
-                std::printf("Executing task %d at %s\n", task->id, time_utils::formatTime(start_time).c_str());
-                task->work();
-                std::this_thread::sleep_for(task->execution_time); // Simulate work1
-                auto end_time = std::chrono::system_clock::now();
-
-                if (end_time > task->next_deadline) {
-                    std::printf("Task %d missed deadline at %s\n", task->id, time_utils::formatTime(end_time).c_str());
-                } else {
-                    std::printf("Task %d completed at %s\n", task->id, time_utils::formatTime(end_time).c_str());
-                }
+    // One pass of the loop: release due jobs, then run the earliest-deadline one or wait
+    // for the next release. Returns false once stopped.
+    bool step() {
+        std::unique_lock<std::mutex> lock(mtx);
+        auto now = clock.now();
+        if (!running || now >= end_of_run) return false;
+
+        // Check for tasks ready to run
+        for (auto& task : tasks) {
+            if (task.next_deadline <= now) {
+                if (trace) std::printf("Task %d ready at %s\n", task.id, time_utils::formatTime(now).c_str());
+                task.next_deadline += task.period; // Schedule next instance
+                ready_queue.push({&task, task.next_deadline});
+            }
+        }
+
+        // Execute highest-priority task
+        if (!ready_queue.empty()) {
+            Job job = ready_queue.top();
+            Task* task = job.task;
+            ready_queue.pop();
+            lock.unlock();
+
+            auto start_time = clock.now();
+            if (trace) std::printf("Executing task %d at %s\n", task->id, time_utils::formatTime(start_time).c_str());
+            if constexpr (Clock::is_virtual) {
+                task->work(task->id);
             } else {
-                // Wait until the next task is ready or new tasks are added
-                if (!tasks.empty()) {
-                    auto next_deadline = tasks[0].next_deadline;
-                    for (const auto& task : tasks) {
-                        if (task.next_deadline < next_deadline)
-                            next_deadline = task.next_deadline;
-                    }
-                    cv.wait_until(lock, next_deadline, [this]() { return !running || !ready_queue.empty(); });
-                } else {
-                    cv.wait(lock, [this]() { return !running || !tasks.empty(); });
+                perf_utils::PerfScope scope("Task::work");
+                task->work(task->id);
+            }
+            clock.sleep_for(task->execution_time); // Simulate work
+            auto end_time = clock.now();
+
+            ++totals.jobs;
+            totals.busy += task->execution_time;
+            if (end_time > job.deadline) {
+                ++totals.misses;
+                totals.max_lateness = std::max(totals.max_lateness, end_time - job.deadline);
+                if (trace) std::printf("Task %d missed deadline at %s\n", task->id, time_utils::formatTime(end_time).c_str());
+            } else {
+                if (trace) std::printf("Task %d completed at %s\n", task->id, time_utils::formatTime(end_time).c_str());
+            }
+        } else {
+            // Wait until the next task is ready or new tasks are added
+            if (!tasks.empty()) {
+                auto next_deadline = tasks[0].next_deadline;
+                for (const auto& task : tasks) {
+                    if (task.next_deadline < next_deadline)
+                        next_deadline = task.next_deadline;
                 }
+                clock.wait_until(cv, lock, std::min(next_deadline, end_of_run),
+                                 [this]() { return !running || !ready_queue.empty(); });
+            } else if constexpr (Clock::is_virtual) {
+                return false; // Nothing will ever be released
+            } else {
+                cv.wait(lock, [this]() { return !running || !tasks.empty(); });
             }
         }
+        return true;
     }
 
 public:
-    Scheduler() : running(false) {}
+    explicit Scheduler(bool _trace = true, Clock _clock = Clock()) : clock(_clock), trace(_trace), running(false) {}
 
-    void addTask(int id, int priority, int period_ms, int exec_time_ms, std::function<void(int)> work) {
+    // First release now (on this scheduler's clock).
+    void addTask(int id, int priority, int period_ms, int exec_time_ms, func_utils::InplaceFunction<void(int)> work) {
         std::lock_guard<std::mutex> lock(mtx);
-        tasks.emplace_back(id, priority, period_ms, exec_time_ms, work);
+        auto now = clock.now();
+        tasks.emplace_back(id, priority, period_ms, exec_time_ms, now, std::move(work));
         cv.notify_one();
-        std::printf("Added task %d to scheduler at %s\n", id, time_utils::formatTime(std::chrono::system_clock::now()).c_str());
+        if (trace) {
+            std::printf("Created task %d: Priority=%d, Period=%dms, ExecTime=%dms at %s\n", id, priority, period_ms,
+                        exec_time_ms, time_utils::formatTime(now).c_str());
+            std::printf("Added task %d to scheduler at %s\n", id, time_utils::formatTime(now).c_str());
+        }
     }
 
-    void start() {
+    // The scheduler thread runs with `config` (affinity, SCHED_FIFO, ...; see rt_thread.h).
+    void start(rt_utils::ThreadConfig config = {}) {
+        static_assert(!Clock::is_virtual, "use simulate() with a virtual clock");
         std::lock_guard<std::mutex> lock(mtx);
         if (!running) {
             running = true;
-            scheduler_thread = std::thread(&Scheduler::schedulerLoop, this);
-            std::printf("Scheduler started at %s\n", time_utils::formatTime(std::chrono::system_clock::now()).c_str());
+            started = clock.now();
+            if (config.name.empty()) config.name = "scheduler";
+            scheduler_thread = rt_utils::make_thread(std::move(config), &Scheduler::schedulerLoop, this);
+            if (trace) std::printf("Scheduler started at %s\n", time_utils::formatTime(started).c_str());
         }
     }
 
     void stop() {
         {
             std::lock_guard<std::mutex> lock(mtx);
+            if (running) totals.elapsed += clock.now() - started;
             running = false;
             cv.notify_one();
         }
         if (scheduler_thread.joinable()) {
             scheduler_thread.join();
-            std::printf("Scheduler stopped at %s\n", time_utils::formatTime(std::chrono::system_clock::now()).c_str());
+            if (trace) std::printf("Scheduler stopped at %s\n", time_utils::formatTime(clock.now()).c_str());
         }
     }
 
+    // Run the loop on the calling thread for `span` of virtual time.
+    SchedulerStats simulate(std::chrono::system_clock::duration span) {
+        static_assert(Clock::is_virtual, "simulate() needs a virtual clock");
+        started = clock.now();
+        end_of_run = started + span;
+        running = true;
+        schedulerLoop();
+        running = false;
+        // The last job may finish after the end of the span.
+        totals.elapsed += std::max(clock.now(), end_of_run) - started;
+        return totals;
+    }
+
+    // Totals so far; elapsed is counted up to the last stop() or simulate().
+    SchedulerStats stats() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return totals;
+    }
+
     ~Scheduler() {
-        stop();
+        if constexpr (!Clock::is_virtual) stop();
     }
 };
 
@@ -140,20 +239,103 @@ void controlLoop(int id) {
     std::printf("Task %d: Executing control loop at %s\n", id, time_utils::formatTime(std::chrono::system_clock::now()).c_str());
 }
 
-int main() {
-    Scheduler scheduler;
+void noWork(int) {}
+
+// Random task set with total utilization `u` (UUniFast), periods from a harmonic-ish menu
+// so hyperperiods stay short. Execution times are whole milliseconds, at least 1ms.
+template <typename Clock>
+void addRandomTasks(Scheduler<Clock>& scheduler, int n, double u, std::mt19937& rng) {
+    static const int periods_ms[] = {10, 20, 25, 40, 50, 100, 200, 250, 500, 1000};
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(std::size(periods_ms)) - 1);
+    double sum = u;
+    for (int i = 0; i < n; ++i) {
+        double next = i + 1 < n ? sum * std::pow(unit(rng), 1.0 / (n - i - 1)) : 0.0;
+        int period = periods_ms[pick(rng)];
+        int exec = std::max(1, static_cast<int>((sum - next) * period + 0.5));
+        scheduler.addTask(i + 1, 1, period, std::min(exec, period), noWork);
+        sum = next;
+    }
+}
+
+// ./scheduler --simulate [hours] [task_sets] [seconds_per_set]
+int simulateMain(int argc, char** argv) {
+    double hours = argc > 2 ? std::atof(argv[2]) : 1.0;
+    int sets = argc > 3 ? std::atoi(argv[3]) : 6000;
+    double seconds_per_set = argc > 4 ? std::atof(argv[4]) : 10.0;
+    using SimScheduler = Scheduler<time_utils::VirtualClock>;
+
+    {
+        SimScheduler scheduler(false);
+        scheduler.addTask(1, 2, 1000, 200, noWork);
+        scheduler.addTask(2, 1, 2000, 300, noWork);
+        scheduler.addTask(3, 3, 500, 100, noWork);
+        auto t0 = std::chrono::steady_clock::now();
+        auto st = scheduler.simulate(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double, std::ratio<3600>>(hours)));
+        double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::printf("Sample task set, %s simulated in %.2fms: %llu jobs, %llu deadline misses, utilization %.3f\n\n",
+                    time_utils::format_duration(st.elapsed).c_str(), wall_ms, static_cast<unsigned long long>(st.jobs),
+                    static_cast<unsigned long long>(st.misses), st.utilization());
+    }
+
+    // Schedulability of random 5-task sets under this (non-preemptive EDF) scheduler.
+    std::mt19937 rng(42);
+    const double targets[] = {0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
+    const int per_target = std::max(1, sets / static_cast<int>(std::size(targets)));
+    auto span = std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(seconds_per_set));
+    std::printf("%d random 5-task sets per target utilization, %.0fs simulated each\n", per_target, seconds_per_set);
+    std::printf("%8s %12s %14s %12s %16s\n", "target U", "no misses", "measured U", "miss rate", "worst late ms");
+    auto t0 = std::chrono::steady_clock::now();
+    for (double target : targets) {
+        int clean = 0;
+        uint64_t jobs = 0, misses = 0;
+        double measured = 0.0;
+        std::chrono::system_clock::duration worst{};
+        for (int s = 0; s < per_target; ++s) {
+            SimScheduler scheduler(false);
+            addRandomTasks(scheduler, 5, target, rng);
+            auto st = scheduler.simulate(span);
+            clean += st.misses == 0;
+            jobs += st.jobs;
+            misses += st.misses;
+            measured += st.utilization();
+            worst = std::max(worst, st.max_lateness);
+        }
+        std::printf("%8.2f %11.1f%% %14.3f %11.3f%% %16.1f\n", target, 100.0 * clean / per_target, measured / per_target,
+                    jobs ? 100.0 * misses / jobs : 0.0, std::chrono::duration<double, std::milli>(worst).count());
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%.0f task sets/s\n", per_target * std::size(targets) / wall_s);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--simulate") == 0) return simulateMain(argc, argv);
+
+    Scheduler<> scheduler;
 
     // Add tasks: (id, priority, period_ms, exec_time_ms, work_function)
     scheduler.addTask(1, 2, 1000, 200, sensorReading); // Sensor reading every 1s, takes 200ms
     scheduler.addTask(2, 1, 2000, 300, controlLoop);   // Control loop every 2s, takes 300ms
     scheduler.addTask(3, 3, 500, 100, sensorReading);  // High-priority sensor every 500ms, takes 100ms
 
-    scheduler.start();
+    // Dispatch at real-time priority when permitted, so task start times do not depend on
+    // whatever else the machine is running.
+    rt_utils::ThreadConfig config;
+    config.policy = rt_utils::Policy::Fifo;
+    config.priority = 70;
+    config.lock_memory = true;
+    scheduler.start(config);
 
     // Run for 10 seconds
     std::this_thread::sleep_for(std::chrono::seconds(10));
 
     scheduler.stop();
 
+    auto st = scheduler.stats();
+    std::printf("%llu jobs, %llu deadline misses, utilization %.3f\n", static_cast<unsigned long long>(st.jobs),
+                static_cast<unsigned long long>(st.misses), st.utilization());
+    perf_utils::perf_report();
     return 0;
 }
@@ -0,0 +1,171 @@
+// sensor_load_harness.cpp
+/*
+ Multi-rate load generator for SensorFusion: find the ingestion saturation point.
+  sensor_data_fusion_gk1.cpp runs three sensors on a fixed 100ms sleep_for. Here thousands
+  of simulated sensors are multiplexed over a few generator threads, each keeping its
+  sensors in a min-heap ordered by next due time (one OS thread per sensor would measure
+  the scheduler, not the fusion path). Every sensor gets:
+    - a rate drawn log-uniformly from 1Hz to 100kHz,
+    - Gaussian jitter on every interval,
+    - optionally a burst profile: BURST_LEN readings back-to-back, then a pause that keeps
+      the average rate unchanged.
+  The step sweep doubles the sensor count until fusion falls behind; each step reports the
+  offered rate, how much the generators actually managed to emit, how much fusion
+  absorbed, drops at the bounded buffer, readings the filter rejected as late (older than
+  its last update: jitter and generators racing each other, not saturation), and
+  sensor -> state latency.
+
+ Usage: ./sensor_load_harness [max_sensors] [seconds_per_step] [generator_threads]
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+#include "./include/sensor_fusion.h"
+
+using namespace fusion;
+using namespace std::chrono_literals;
+
+constexpr double MIN_HZ = 1.0;
+constexpr double MAX_HZ = 100'000.0;
+constexpr double JITTER = 0.1;           // Interval standard deviation, fraction of interval
+constexpr double BURSTY_FRACTION = 0.1;  // Share of sensors that emit in bursts
+constexpr int BURST_LEN = 32;
+constexpr std::size_t MAX_PENDING = 1 << 18;
+
+struct SimSensor {
+    int id;
+    double interval_s;
+    bool bursty;
+    int burst_left = 0;
+};
+
+std::vector<SimSensor> make_sensors(int count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> log_rate(std::log(MIN_HZ), std::log(MAX_HZ));
+    std::bernoulli_distribution bursty(BURSTY_FRACTION);
+    std::vector<SimSensor> sensors;
+    for (int i = 0; i < count; ++i) sensors.push_back({i, 1.0 / std::exp(log_rate(rng)), bursty(rng)});
+    return sensors;
+}
+
+// Drive `mine` (indices into sensors) until `until`, submitting into `fusion`.
+void generator(SensorFusion& fusion, std::vector<SimSensor>& sensors, std::vector<int> mine,
+               steady_clock::time_point until, uint32_t seed, std::atomic<uint64_t>& emitted,
+               std::atomic<uint64_t>& accepted) {
+    using Due = std::pair<steady_clock::time_point, int>;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> heap;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> jitter(1.0, JITTER);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> phase(0.0, 1.0);
+
+    auto start = steady_clock::now();
+    for (int idx : mine) {
+        auto first = start + std::chrono::duration_cast<steady_clock::duration>(
+                                 std::chrono::duration<double>(sensors[idx].interval_s * phase(rng)));
+        heap.push({first, idx});
+    }
+
+    uint64_t local_emitted = 0, local_accepted = 0;
+    while (!heap.empty()) {
+        auto [due, idx] = heap.top();
+        auto now = steady_clock::now();
+        if (due >= until || now >= until) break; // A lagging generator still stops on time
+        if (due > now + 50us) {
+            std::this_thread::sleep_until(due);
+            now = steady_clock::now();
+        }
+        heap.pop();
+
+        SimSensor& s = sensors[idx];
+        double t = std::chrono::duration<double>(now - start).count();
+        SensorData data{50.0 + 20.0 * std::sin(0.5 * t) + noise(rng), now, s.id};
+        ++local_emitted;
+        if (fusion.submit(data)) ++local_accepted;
+
+        double next_s = s.interval_s * std::max(0.0, jitter(rng));
+        if (s.bursty) {
+            // BURST_LEN readings back to back, then one long gap with the same mean rate.
+            if (s.burst_left == 0) s.burst_left = BURST_LEN;
+            next_s = --s.burst_left > 0 ? 0.0 : s.interval_s * BURST_LEN;
+        }
+        heap.push({due + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(next_s)), idx});
+    }
+    emitted += local_emitted;
+    accepted += local_accepted;
+}
+
+bool run_step(int sensor_count, double seconds, int generators) {
+    auto sims = make_sensors(sensor_count, 12345);
+    double target = 0.0;
+    for (const auto& s : sims) target += 1.0 / s.interval_s;
+
+    std::vector<SensorModel> models(sensor_count, SensorModel{"sim", MeasurementKind::Position, 1.0});
+    SensorFusion fusion(std::move(models), 25.0, FusionTrigger::every_reading());
+    fusion.set_debug(false);
+    fusion.set_max_pending(MAX_PENDING);
+
+    std::atomic<uint64_t> emitted{0}, accepted{0};
+    auto start = steady_clock::now();
+    auto until = start + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(seconds));
+    std::thread fuser([&fusion]() { fusion.fusion_thread(); });
+    std::vector<std::thread> gens;
+    for (int g = 0; g < generators; ++g) {
+        std::vector<int> mine;
+        for (int i = g; i < sensor_count; i += generators) mine.push_back(i);
+        gens.emplace_back(generator, std::ref(fusion), std::ref(sims), std::move(mine), until,
+                          static_cast<uint32_t>(g + 1), std::ref(emitted), std::ref(accepted));
+    }
+    for (auto& t : gens) t.join();
+    double elapsed = std::chrono::duration<double>(steady_clock::now() - start).count();
+    uint64_t fused = fusion.fused_readings();
+    uint64_t late = fusion.late_readings();
+    std::size_t backlog = fusion.pending_readings();
+    fusion.stop();
+    fuser.join();
+
+    auto hist = fusion.latency_histogram();
+    double emitted_rate = emitted.load() / elapsed;
+    double fused_rate = fused / elapsed;
+    uint64_t drops = fusion.dropped_readings();
+    double late_rate = late / elapsed;
+    std::printf("%8d %12.0f %12.0f %12.0f %10.0f %10llu %9zu %10.1f %10.1f %10.1f\n", sensor_count, target,
+                emitted_rate, fused_rate, late_rate, static_cast<unsigned long long>(drops), backlog,
+                hist.percentile(50) / 1e3, hist.percentile(99) / 1e3, hist.max() / 1e3);
+
+    if (emitted_rate < 0.9 * target) {
+        std::printf("Generators saturated: raise generator_threads to offer this load\n");
+        return true;
+    }
+    if (drops > 0 || fused_rate + late_rate < 0.95 * emitted_rate) { // Late readings were absorbed, just not applied
+        std::printf("Fusion saturated: absorbs %.0f readings/s\n", fused_rate);
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread sensor_load_harness.cpp -o sensor_load_harness\n");
+    int max_sensors = argc > 1 ? std::atoi(argv[1]) : 4096;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int generators = argc > 3 ? std::atoi(argv[3]) : std::max(1, hw - 1);
+
+    std::printf("Rates %.0fHz-%.0fkHz log-uniform, jitter %.0f%%, %.0f%% bursty (x%d), %d generator thread(s), %.1fs per step\n",
+                MIN_HZ, MAX_HZ / 1e3, JITTER * 100, BURSTY_FRACTION * 100, BURST_LEN, generators, seconds);
+    std::printf("%8s %12s %12s %12s %10s %10s %9s %10s %10s %10s\n", "sensors", "offered/s", "emitted/s",
+                "fused/s", "late/s", "dropped", "backlog", "p50 us", "p99 us", "max us");
+    for (int sensors = 8; sensors <= max_sensors; sensors *= 2) {
+        if (run_step(sensors, seconds, generators)) break;
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+// shm_ring_bench.cpp
+/*
+ A sensor process publishing readings to a fusion process: ShmRing in shared memory
+ (include/shm_ring.h) vs a Unix-domain socket.
+  The parent process is the consumer (fusion); a fork()ed child is the producer (sensor).
+  The ring lives in a shm_open region that the child opens again by name, so the two
+  processes map it at different addresses. The socket is a SOCK_SEQPACKET socketpair, one
+  reading per message.
+    throughput  the sensor publishes as fast as it can (retrying with sched_yield when
+                the ring is full; the socket blocks in write). msgs/s at the consumer,
+                and syscalls per message: futex wakes + waits plus the producer's
+                sched_yield calls for the ring, write + read for the socket.
+    latency     the sensor publishes every `period_us` (absolute release times); the
+                consumer blocks for each reading and records sent -> received (both sides
+                read CLOCK_MONOTONIC, which steady_clock uses). At this rate the consumer
+                sleeps between readings, so each one costs a wake and a wait, as many
+                syscalls as the socket; the ring avoids them whenever the consumer is
+                still busy or spinning when the next reading is published.
+  Readings are 64B and 1KB. The ring producer writes in place (claim/publish) and the
+  consumer reads in place (wait/release); the socket copies each reading into and out of
+  the kernel.
+
+ Usage: ./shm_ring_bench [millions_of_messages] [latency_seconds] [period_us]
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <sched.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "./include/latency_histogram.h"
+#include "./include/shm_ring.h"
+
+using Clock = std::chrono::steady_clock;
+using perf_utils::LatencyHistogram;
+
+constexpr std::size_t CAPACITY = 1024;
+constexpr auto STALL_TIMEOUT = std::chrono::seconds(2); // No reading for this long: the producer died or hung
+
+template <std::size_t N>
+struct Reading {
+    uint64_t seq;
+    int64_t sent_ns; // steady_clock, comparable across processes
+    double value;
+    int32_t sensor_id;
+    std::array<unsigned char, N - 28> payload;
+};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+template <std::size_t N>
+void fill(Reading<N>& r, uint64_t seq) {
+    r.seq = seq;
+    r.value = static_cast<double>(seq) * 0.5;
+    r.sensor_id = 1;
+    r.payload[0] = static_cast<unsigned char>(seq);
+    r.payload[N - 29] = static_cast<unsigned char>(seq >> 8);
+    r.sent_ns = now_ns(); // Last, so latency covers the hand-off only
+}
+
+struct Result {
+    double msgs_per_s = 0.0;
+    double syscalls_per_msg = 0.0;
+    LatencyHistogram latency;
+    bool ok = true;
+};
+
+// Producer schedule: `count` readings, as fast as possible (period 0) or one per period.
+struct Schedule {
+    uint64_t count;
+    std::chrono::nanoseconds period;
+};
+
+template <typename Publish>
+void produce(const Schedule& s, Publish publish) {
+    auto release = Clock::now();
+    for (uint64_t i = 0; i < s.count; ++i) {
+        if (s.period.count() > 0) {
+            release += s.period;
+            std::this_thread::sleep_until(release);
+        }
+        publish(i);
+    }
+}
+
+// Run `child` in a forked producer process; returns false if it failed.
+template <typename Child>
+bool fork_producer(pid_t& pid, Child child) {
+    std::fflush(stdout); // Or the child inherits and prints the pending output again
+    pid = fork();
+    if (pid < 0) {
+        std::perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        child();
+        _exit(0);
+    }
+    return true;
+}
+
+bool reap(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Producer-side counters, placed after the ring in the same region so the parent can read
+// them once the child has exited.
+struct ProducerStats {
+    std::atomic<uint64_t> yields{0}; // sched_yield calls while the ring was full
+};
+
+template <std::size_t N>
+Result run_shm(const Schedule& s) {
+    using Ring = sync_utils::ShmRing<Reading<N>, CAPACITY>;
+    const std::string name = "/shm_ring_bench-" + std::to_string(getpid());
+    auto region = sync_utils::ShmRegion::create(name, Ring::bytes() + sizeof(ProducerStats));
+    Ring* ring = Ring::create(region.data());
+    auto* producer = ::new (static_cast<char*>(region.data()) + Ring::bytes()) ProducerStats;
+
+    pid_t pid;
+    if (!fork_producer(pid, [&]() {
+            auto mine = sync_utils::ShmRegion::open(name, Ring::bytes() + sizeof(ProducerStats)); // Different address from the parent's
+            Ring* r = Ring::attach(mine.data());
+            if (!r) _exit(2);
+            auto* stats = std::launder(reinterpret_cast<ProducerStats*>(static_cast<char*>(mine.data()) + Ring::bytes()));
+            uint64_t yields = 0;
+            produce(s, [&](uint64_t i) {
+                Reading<N>* slot;
+                while (!(slot = r->claim())) { // Throughput run only: latency runs never fill the ring
+                    sched_yield();
+                    ++yields;
+                }
+                fill(*slot, i);
+                r->publish();
+            });
+            stats->yields.store(yields, std::memory_order_relaxed); // Read after waitpid()
+        }))
+        return {};
+
+    Result res;
+    uint64_t expected = 0;
+    auto t0 = Clock::now();
+    for (; expected < s.count; ++expected) {
+        const Reading<N>* m = ring->wait(STALL_TIMEOUT);
+        if (!m) {
+            std::fprintf(stderr, "shm: no reading %llu of %llu within %llds, stopping the producer\n",
+                         static_cast<unsigned long long>(expected), static_cast<unsigned long long>(s.count),
+                         static_cast<long long>(STALL_TIMEOUT.count()));
+            kill(pid, SIGKILL); // Dead already, or hung: either way reap() must not block
+            res.ok = false;
+            break;
+        }
+        res.latency.record(static_cast<uint64_t>(std::max<int64_t>(now_ns() - m->sent_ns, 0)));
+        res.ok = res.ok && m->seq == expected && m->payload[0] == static_cast<unsigned char>(expected) &&
+                 m->payload[N - 29] == static_cast<unsigned char>(expected >> 8);
+        ring->release();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    res.ok = reap(pid) && res.ok;
+    auto st = ring->stats();
+    res.msgs_per_s = expected / seconds;
+    res.syscalls_per_msg =
+        static_cast<double>(st.wakes + st.sleeps + producer->yields.load(std::memory_order_relaxed)) / s.count;
+    return res;
+}
+
+template <std::size_t N>
+Result run_socket(const Schedule& s) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) != 0) {
+        std::perror("socketpair");
+        return {};
+    }
+    pid_t pid;
+    if (!fork_producer(pid, [&]() {
+            close(sv[0]);
+            Reading<N> r;
+            produce(s, [&](uint64_t i) {
+                fill(r, i);
+                if (write(sv[1], &r, sizeof(r)) != static_cast<ssize_t>(sizeof(r))) _exit(3);
+            });
+            close(sv[1]);
+        }))
+        return {};
+    close(sv[1]);
+
+    Result res;
+    Reading<N> m;
+    auto t0 = Clock::now();
+    for (uint64_t expected = 0; expected < s.count; ++expected) {
+        if (read(sv[0], &m, sizeof(m)) != static_cast<ssize_t>(sizeof(m))) {
+            res.ok = false;
+            break;
+        }
+        res.latency.record(static_cast<uint64_t>(std::max<int64_t>(now_ns() - m.sent_ns, 0)));
+        res.ok = res.ok && m.seq == expected && m.payload[0] == static_cast<unsigned char>(expected) &&
+                 m.payload[N - 29] == static_cast<unsigned char>(expected >> 8);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    close(sv[0]);
+    res.ok = reap(pid) && res.ok;
+    res.msgs_per_s = s.count / seconds;
+    res.syscalls_per_msg = 2.0;
+    return res;
+}
+
+template <std::size_t N>
+void compare(uint64_t messages, double latency_seconds, std::chrono::microseconds period) {
+    static_assert(sizeof(Reading<N>) == N);
+    std::printf("\n%zu-byte readings\n", N);
+    std::printf("  %-10s %-8s %12s %10s %9s %9s %9s %9s\n", "run", "transport", "msgs/s", "syscalls", "p50 us",
+                "p99 us", "p99.9 us", "max us");
+    auto row = [](const char* run, const char* transport, const Result& r) {
+        const auto& h = r.latency;
+        std::printf("  %-10s %-8s %12.0f %10.3f %9.1f %9.1f %9.1f %9.1f%s\n", run, transport, r.msgs_per_s,
+                    r.syscalls_per_msg, h.percentile(50) / 1e3, h.percentile(99) / 1e3, h.percentile(99.9) / 1e3,
+                    h.max() / 1e3, r.ok ? "" : "  FAILED (sequence/payload mismatch or producer error)");
+    };
+    Schedule flat{messages, std::chrono::nanoseconds::zero()};
+    row("throughput", "shm", run_shm<N>(flat));
+    row("throughput", "socket", run_socket<N>(flat));
+    Schedule paced{static_cast<uint64_t>(latency_seconds * 1e6 / period.count()), period};
+    row("latency", "shm", run_shm<N>(paced));
+    row("latency", "socket", run_socket<N>(paced));
+}
+
+int main(int argc, char** argv) {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread shm_ring_bench.cpp -o shm_ring_bench\n\n");
+    auto messages = static_cast<uint64_t>((argc > 1 ? std::atof(argv[1]) : 2.0) * 1e6);
+    double latency_seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    auto period = std::chrono::microseconds(argc > 3 ? std::atoi(argv[3]) : 100);
+    std::printf("sensor process -> fusion process, ring capacity %zu, throughput: %llu readings, "
+                "latency: one every %lldus for %.1fs\n", CAPACITY, static_cast<unsigned long long>(messages),
+                static_cast<long long>(period.count()), latency_seconds);
+    std::printf("(latency in the throughput rows includes queueing behind a full ring / socket buffer)\n");
+    compare<64>(messages, latency_seconds, period);
+    compare<1024>(messages / 4, latency_seconds, period);
+    return 0;
+}
@@ -0,0 +1,180 @@
+// state_history_bench.cpp
+/*
+ Query latency of the fused-state history ring under concurrent appends.
+  A writer appends StateEstimates (synthetic 100us spacing) as fast as it can while reader
+  threads ask for the interpolated value at a random time in the retained window and for
+  min/max/mean/trend over the last 10ms. Each query is timed individually. The same
+  workload runs against a mutex-guarded ring as the baseline; readers of StateHistory
+  never take a lock, so their latency does not depend on the writer holding one.
+  Finally SensorFusion's own history is queried while it runs.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "./include/latency_histogram.h"
+#include "./include/sensor_fusion.h"
+#include "./include/state_history.h"
+
+using namespace fusion;
+using namespace std::chrono_literals;
+using perf_utils::LatencyHistogram;
+
+constexpr std::size_t CAPACITY = 4096;
+constexpr auto SPACING = 100us;
+
+// Baseline: same queries over a plain ring guarded by one mutex.
+class LockedHistory {
+public:
+    void append(const StateEstimate& e) {
+        std::lock_guard<std::mutex> lock(mtx);
+        ring[head % CAPACITY] = e;
+        ++head;
+    }
+
+    std::optional<StateEstimate> latest() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (head == 0) return std::nullopt;
+        return ring[(head - 1) % CAPACITY];
+    }
+
+    std::optional<StateEstimate> value_at(steady_clock::time_point t) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (head < 2) return std::nullopt;
+        uint64_t lo = head > CAPACITY ? head - CAPACITY : 0;
+        uint64_t left = lo, right = head - 1;
+        if (t >= ring[right % CAPACITY].last_updated) return ring[right % CAPACITY];
+        if (t < ring[left % CAPACITY].last_updated) return std::nullopt;
+        while (right - left > 1) {
+            uint64_t mid = left + (right - left) / 2;
+            if (ring[mid % CAPACITY].last_updated <= t) left = mid;
+            else right = mid;
+        }
+        const auto& a = ring[left % CAPACITY];
+        const auto& b = ring[right % CAPACITY];
+        double w = std::chrono::duration<double>(t - a.last_updated) / (b.last_updated - a.last_updated);
+        return StateEstimate{a.fused_value + w * (b.fused_value - a.fused_value), t, a.velocity, a.variance};
+    }
+
+    WindowStats window(steady_clock::time_point from, steady_clock::time_point to) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        WindowStats st;
+        double sum = 0.0;
+        st.min = INFINITY;
+        st.max = -INFINITY;
+        uint64_t lo = head > CAPACITY ? head - CAPACITY : 0;
+        for (uint64_t i = head; i > lo; --i) {
+            const auto& e = ring[(i - 1) % CAPACITY];
+            if (e.last_updated > to) continue;
+            if (e.last_updated < from) break;
+            st.min = std::min(st.min, e.fused_value);
+            st.max = std::max(st.max, e.fused_value);
+            sum += e.fused_value;
+            ++st.count;
+        }
+        if (st.count) st.mean = sum / st.count;
+        return st;
+    }
+
+private:
+    mutable std::mutex mtx;
+    StateEstimate ring[CAPACITY];
+    uint64_t head = 0;
+};
+
+template <typename History>
+void run(const char* label, bool concurrent_writer, int readers) {
+    History history;
+    const auto base = steady_clock::time_point{} + 1h;
+    auto make = [&](uint64_t i) {
+        double s = static_cast<double>(i) * 1e-4;
+        return StateEstimate{50.0 + 20.0 * std::sin(0.5 * s), base + i * SPACING, 10.0 * std::cos(0.5 * s), 0.01};
+    };
+    uint64_t next = 0;
+    for (; next < CAPACITY; ++next) history.append(make(next));
+
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> appended{0};
+    std::thread writer;
+    if (concurrent_writer) {
+        writer = std::thread([&]() {
+            uint64_t i = next;
+            while (running.load(std::memory_order_relaxed)) history.append(make(i++));
+            appended = i - next;
+        });
+    }
+
+    std::vector<LatencyHistogram> point(readers), window(readers);
+    std::atomic<long> lapped{0}; // Queries whose window the writer overwrote meanwhile
+    std::vector<std::thread> pool;
+    for (int r = 0; r < readers; ++r) {
+        pool.emplace_back([&, r]() {
+            std::mt19937 rng(r);
+            std::uniform_int_distribution<int> back(0, static_cast<int>(CAPACITY) / 2);
+            for (int q = 0; q < 200'000; ++q) {
+                auto newest = history.latest()->last_updated;
+                auto t = newest - back(rng) * SPACING - SPACING / 2;
+
+                auto t0 = std::chrono::steady_clock::now();
+                auto v = history.value_at(t);
+                auto t1 = std::chrono::steady_clock::now();
+                auto st = history.window(newest - 10ms, newest);
+                auto t2 = std::chrono::steady_clock::now();
+                point[r].record(t1 - t0);
+                window[r].record(t2 - t1);
+                if (!v || st.count == 0) lapped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    running = false;
+    if (writer.joinable()) writer.join();
+
+    for (int r = 1; r < readers; ++r) {
+        point[0].merge(point[r]);
+        window[0].merge(window[r]);
+    }
+    std::printf("%s, %d reader(s), writer %s (%llu appends during run, %ld queries lapped)\n", label, readers,
+                concurrent_writer ? "appending" : "idle", static_cast<unsigned long long>(appended.load()),
+                lapped.load());
+    point[0].print("  value_at(t)");
+    window[0].print("  window(10ms)");
+}
+
+void sensor_fusion_demo() {
+    SensorFusion fusion({
+        {"IMU", MeasurementKind::Velocity, 0.5},
+        {"Camera", MeasurementKind::Position, 2.0},
+        {"Lidar", MeasurementKind::Range, 0.3, 5.0},
+    }, 25.0, FusionTrigger::every_reading());
+    fusion.set_debug(false);
+    std::vector<std::jthread> threads;
+    threads.emplace_back([&fusion]() { fusion.sensor_thread("IMU", 0, 1ms); });
+    threads.emplace_back([&fusion]() { fusion.sensor_thread("Camera", 1, 1ms); });
+    threads.emplace_back([&fusion]() { fusion.sensor_thread("Lidar", 2, 1ms); });
+    threads.emplace_back([&fusion]() { fusion.fusion_thread(); });
+    std::this_thread::sleep_for(1s);
+
+    auto now = steady_clock::now();
+    auto past = fusion.history().value_at(now - 500ms);
+    auto st = fusion.history().window(now - 100ms, now);
+    std::printf("SensorFusion history: %zu entries, value 500ms ago = %.3f, last 100ms: n=%zu min=%.3f max=%.3f mean=%.3f trend=%.3f/s\n",
+                fusion.history().size(), past ? past->fused_value : NAN, st.count, st.min, st.max, st.mean, st.trend);
+    fusion.stop();
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread state_history_bench.cpp -o state_history_bench\n");
+    int readers = std::max(1u, std::thread::hardware_concurrency() / 2);
+    run<StateHistory<CAPACITY>>("StateHistory (lock-free readers)", false, readers);
+    run<StateHistory<CAPACITY>>("StateHistory (lock-free readers)", true, readers);
+    run<LockedHistory>("Mutex-guarded ring", false, readers);
+    run<LockedHistory>("Mutex-guarded ring", true, readers);
+    sensor_fusion_demo();
+    return 0;
+}
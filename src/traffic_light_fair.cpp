@@ -0,0 +1,255 @@
+// traffic_light_fair.cpp
+/*
+ Fair Traffic Light Controlled Intersection:
+  The LeetCode TrafficLight (traffic_light_gk1.cpp) lets whichever car grabs the mutex first
+  go through, flipping the light whenever that car is on the red road. Under load this both
+  starves a road (no bound on how long a red road waits) and thrashes the light (one switch
+  per car in the worst case), and every switch costs a clearance interval in real life.
+
+  This version keeps the same carArrived() contract but:
+    - queues cars per road in FIFO order, each car parked on its own condition variable so
+      a hand-off wakes exactly the next car instead of every waiter,
+    - asks a pluggable SwitchPolicy at each decision point whether to hand green over,
+    - records per-road waiting time (arrival -> goThrough) in a histogram plus switch counts,
+  so policies can be compared on throughput vs. p99 wait with measurements.
+
+  Policies:
+    ArrivalOrderPolicy     - oldest waiting car wins (what the mutex race approximates).
+    AlternatingSlicePolicy - green holds for a fixed time slice while the red road waits.
+    QueueWeightedPolicy    - switch when the red queue outweighs the green queue by a ratio.
+    MaxWaitPolicy          - keep green until the oldest red car has waited a bound.
+  All policies are work-conserving: an empty green road always yields to a waiting red road.
+*/
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include "./include/inplace_function.h"
+#include "./include/latency_histogram.h"
+
+using std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+// Snapshot of one road handed to the policy (taken under the intersection lock).
+struct RoadView {
+    int waiting;                               // Cars queued on this road.
+    steady_clock::duration oldest_wait;        // Wait time of the head-of-line car (0 if none).
+};
+
+struct PhaseView {
+    RoadView green;
+    RoadView red;
+    steady_clock::duration green_for;          // Time since the light last switched.
+    int passed_in_phase;                       // Cars served since the last switch.
+};
+
+class SwitchPolicy {
+public:
+    virtual ~SwitchPolicy() = default;
+    virtual const char* name() const = 0;
+    // Called only when both roads have waiting cars; true hands green to the red road.
+    virtual bool should_switch(const PhaseView& view) const = 0;
+};
+
+class ArrivalOrderPolicy : public SwitchPolicy {
+public:
+    const char* name() const override { return "arrival-order"; }
+    bool should_switch(const PhaseView& v) const override {
+        return v.red.oldest_wait > v.green.oldest_wait;
+    }
+};
+
+class AlternatingSlicePolicy : public SwitchPolicy {
+public:
+    explicit AlternatingSlicePolicy(steady_clock::duration slice) : slice(slice) {}
+    const char* name() const override { return "alternating-slice"; }
+    bool should_switch(const PhaseView& v) const override { return v.green_for >= slice; }
+
+private:
+    steady_clock::duration slice;
+};
+
+class QueueWeightedPolicy : public SwitchPolicy {
+public:
+    QueueWeightedPolicy(double ratio, int min_green_cars) : ratio(ratio), min_green_cars(min_green_cars) {}
+    const char* name() const override { return "queue-weighted"; }
+    bool should_switch(const PhaseView& v) const override {
+        if (v.passed_in_phase < min_green_cars) return false; // Hysteresis against thrash.
+        return v.red.waiting > ratio * v.green.waiting;
+    }
+
+private:
+    double ratio;
+    int min_green_cars;
+};
+
+class MaxWaitPolicy : public SwitchPolicy {
+public:
+    explicit MaxWaitPolicy(steady_clock::duration bound) : bound(bound) {}
+    const char* name() const override { return "max-wait"; }
+    bool should_switch(const PhaseView& v) const override { return v.red.oldest_wait >= bound; }
+
+private:
+    steady_clock::duration bound;
+};
+
+class TrafficLight {
+private:
+    struct Waiter {
+        steady_clock::time_point arrival;
+        std::condition_variable cv;
+    };
+
+    struct Road {
+        std::deque<Waiter*> queue; // FIFO of waiting cars (waiters live on their own stacks).
+        perf_utils::LatencyHistogram wait_hist;
+    };
+
+    std::unique_ptr<SwitchPolicy> policy;
+    Road roads[2];
+    int greenRoad = 1;     // Road the light currently favours (1 = A, 2 = B).
+    int lightRoad = 1;     // Road the physical light is green for (updated via turnGreen).
+    bool busy = false;     // A car is inside the intersection.
+    long switches = 0;
+    int passed_in_phase = 0;
+    steady_clock::time_point phase_start = steady_clock::now();
+    std::mutex mtx;
+
+    RoadView view_of(const Road& road, steady_clock::time_point now) const {
+        if (road.queue.empty()) return {0, steady_clock::duration::zero()};
+        return {static_cast<int>(road.queue.size()), now - road.queue.front()->arrival};
+    }
+
+    // Decide which road is favoured next. Caller holds mtx.
+    void decide(steady_clock::time_point now) {
+        Road& green = roads[greenRoad - 1];
+        Road& red = roads[2 - greenRoad];
+        if (red.queue.empty()) return;
+        bool hand_over = green.queue.empty();
+        if (!hand_over) {
+            PhaseView v{view_of(green, now), view_of(red, now), now - phase_start, passed_in_phase};
+            hand_over = policy->should_switch(v);
+        }
+        if (hand_over) {
+            greenRoad = 3 - greenRoad;
+            passed_in_phase = 0;
+            phase_start = now;
+        }
+    }
+
+    // Wake the head-of-line car of the favoured road, if any. Caller holds mtx.
+    void wake_next() {
+        Road& green = roads[greenRoad - 1];
+        if (!green.queue.empty()) green.queue.front()->cv.notify_one();
+    }
+
+public:
+    explicit TrafficLight(std::unique_ptr<SwitchPolicy> p = std::make_unique<ArrivalOrderPolicy>())
+        : policy(std::move(p)) {}
+
+    void carArrived(
+        int carId,                   // Car's unique ID.
+        int roadId,                  // 1 for Road A, 2 for Road B.
+        int direction,               // 1 for left, 2 for right.
+        func_utils::function_ref<void()> turnGreen,  // Function to turn light green.
+        func_utils::function_ref<void()> goThrough   // Function to let car pass.
+    ) {
+        (void)carId;
+        (void)direction;
+        Road& road = roads[roadId - 1];
+        std::unique_lock<std::mutex> lock(mtx);
+        Waiter self;
+        self.arrival = steady_clock::now();
+        road.queue.push_back(&self);
+        if (!busy) {
+            decide(self.arrival);
+            wake_next();
+        }
+
+        self.cv.wait(lock, [&]() {
+            return !busy && greenRoad == roadId && road.queue.front() == &self;
+        });
+        busy = true;
+        road.queue.pop_front();
+        if (lightRoad != roadId) {
+            turnGreen();
+            lightRoad = roadId;
+            ++switches;
+        }
+        road.wait_hist.record(steady_clock::now() - self.arrival); // Arrival -> goThrough
+        lock.unlock();
+
+        // The intersection is held by this car; the light state cannot change underneath it.
+        goThrough();
+
+        lock.lock();
+        auto now = steady_clock::now();
+        ++passed_in_phase;
+        busy = false;
+        decide(now);
+        wake_next();
+    }
+
+    void report(steady_clock::duration elapsed) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto served = roads[0].wait_hist.count() + roads[1].wait_hist.count();
+        double secs = std::chrono::duration<double>(elapsed).count();
+        std::printf("policy=%s cars=%llu switches=%ld throughput=%.0f cars/s\n",
+                    policy->name(), static_cast<unsigned long long>(served), switches, served / secs);
+        roads[0].wait_hist.print("  Road A wait");
+        roads[1].wait_hist.print("  Road B wait");
+    }
+};
+
+// Busy-wait so the simulated costs are not dominated by timer slack.
+static void spin_for(steady_clock::duration d) {
+    auto until = steady_clock::now() + d;
+    while (steady_clock::now() < until) {}
+}
+
+// Road A carries heavy traffic, road B light traffic: the classic starvation setup.
+static void run_load(std::unique_ptr<SwitchPolicy> policy, int cars_a, int cars_b) {
+    TrafficLight light(std::move(policy));
+    auto turnGreen = []() { spin_for(200us); };  // Clearance interval paid on every switch.
+    auto goThrough = []() { spin_for(20us); };   // Time a car occupies the intersection.
+
+    auto start = steady_clock::now();
+    std::vector<std::thread> cars;
+    auto spawn_road = [&](int roadId, int count, steady_clock::duration mean_gap, unsigned seed) {
+        cars.emplace_back([&, roadId, count, mean_gap, seed]() {
+            std::mt19937 rng(seed);
+            std::exponential_distribution<double> gap(1.0);
+            std::vector<std::thread> road_cars;
+            for (int i = 0; i < count; ++i) {
+                std::this_thread::sleep_for(std::chrono::duration_cast<steady_clock::duration>(mean_gap * gap(rng)));
+                int carId = roadId * 100000 + i;
+                road_cars.emplace_back([&, carId, roadId]() {
+                    light.carArrived(carId, roadId, 1, turnGreen, goThrough);
+                });
+            }
+            for (auto& t : road_cars) t.join();
+        });
+    };
+    spawn_road(1, cars_a, 30us, 1);
+    spawn_road(2, cars_b, 300us, 2);
+    for (auto& t : cars) t.join();
+    light.report(steady_clock::now() - start);
+}
+
+int main() {
+    std::printf("Compile: g++ -std=c++20 -O2 -pthread traffic_light_fair.cpp -o traffic_light_fair\n");
+    const int cars_a = 2000;
+    const int cars_b = 200;
+
+    run_load(std::make_unique<ArrivalOrderPolicy>(), cars_a, cars_b);
+    run_load(std::make_unique<AlternatingSlicePolicy>(2ms), cars_a, cars_b);
+    run_load(std::make_unique<QueueWeightedPolicy>(0.5, 8), cars_a, cars_b);
+    run_load(std::make_unique<MaxWaitPolicy>(5ms), cars_a, cars_b);
+    return 0;
+}
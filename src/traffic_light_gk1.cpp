@@ -19,7 +19,7 @@ The Traffic Light Controlled Intersection:
 
 #include <mutex>
 #include <thread>
-#include <functional>
+#include "./include/inplace_function.h"
 #include <chrono>
 #include <cstdio>
 
@@ -37,8 +37,8 @@ public:
         int carId,                   // Car's unique ID.
         int roadId,                  // 1 for Road A, 2 for Road B.
         int direction,               // 1 for left, 2 for right.
-        std::function<void()> turnGreen,  // Function to turn light green.
-        std::function<void()> goThrough   // Function to let car pass.
+        func_utils::function_ref<void()> turnGreen,  // Function to turn light green.
+        func_utils::function_ref<void()> goThrough   // Function to let car pass.
     ) {
         std::lock_guard<std::mutex> lock(mtx); // Lock for thread safety.
         if (roadId != greenRoad) {